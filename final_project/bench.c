@@ -0,0 +1,654 @@
+/*  Tabamo, Euan Jed S. - ST2L - June 2, 2024
+    Final Project - Flight Passenger Management System
+    Benchmarks - generated databases, timed operations, and a booking stress test (built against flightdb.h)
+*/
+
+#define _POSIX_C_SOURCE 200809L // for mkdtemp() and the POSIX headers under -std=c11
+
+#include "flightdb.h"
+#include "workload.h"
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Benchmark Constants/Definitions */
+
+#define BENCHMARK_DEFAULT_RECORDS 1000000         // the default number of flights generated by --bench-reader
+#define BENCHMARK_READER_FILE "bench_flights.txt" // the string representing the file generated by --bench-reader
+#define BENCHMARK_LOAD_RUNS 5                     // the number of timed loads and saves of --bench
+#define BENCHMARK_RENDER_RUNS 5                   // the number of timed listings of --bench
+#define BENCHMARK_OUTPUT_SIZE (64 * 1024)         // the number of bytes the timed listings are written in at once
+#define BENCHMARK_SAMPLES 200000                  // the number of timed searches and conflict checks of --bench
+#define BENCHMARK_ITINERARIES 2000                // the number of timed itinerary searches of --bench (each can scan many Flights)
+#define BENCHMARK_DIRECTORY "/tmp/ejstabamo_bench.XXXXXX" // the template of the temporary directory --bench generates its database in
+#define BENCHMARK_BOOKINGS 400000                 // the number of bookings --bench-booking splits between its threads
+#define BENCHMARK_MIN_THREADS 4                   // the number of threads --bench-booking goes up to at least (even with fewer cores)
+#define BENCHMARK_MAX_THREADS 256                 // the maximum number of threads of --bench-booking
+
+/* Structures */
+
+typedef struct BookingWorker // A thread of the booking benchmark and what it did.
+{
+    FlightDB *db;                 // A ptr to the database shared by every thread
+    Workload *workload;           // A ptr to the sizes of the database (to pick random Flights and Passengers)
+    long operations;              // A long for the number of bookings to try (a quarter of the ones made are cancelled again)
+    unsigned long long seed;      // An unsigned long long for the thread's own random seed
+    long booked;                  // A long for the number of bookings made
+    long cancelled;               // A long for the number of bookings cancelled right after they were made
+    long refused;                 // A long for the number of bookings refused (full, conflicting, or already reserved)
+} BookingWorker;
+
+/* General Helper Functions */
+
+void out_of_memory();          // Cleanly exits the program when there is no more memory left
+void print_status(int status); // Prints the message of a status code a change was refused with
+
+/* Benchmark Functions */
+
+void benchmark_line_reader(long records);                            // Times read_line() against a LineReader on a generated flights file
+void benchmark_database(Workload *workload);                         // Times loading, saving, searching, route searches, conflict checks, and listings of a generated database
+void benchmark_listing(FlightDB *db, bool available, FILE *fp);      // Formats the rows of a listing of the bookable Flights or of every Flight to a file
+void remove_directory(char *directory);                              // Deletes a directory and the files in it
+void benchmark_booking(int max_threads, Workload *workload);         // Times bookings made by 1, 2, 4, ... threads sharing one generated database
+void *booking_worker(void *arg);                                     // Books random Flights for random Passengers (the body of a BookingWorker thread)
+bool check_bookings(FlightDB *db);                                   // Checks that every Flight's passenger count matches its reservations and seats
+bool check_journal(FlightDB *db, char *directory);                   // Checks that loading the journal again gives the same seats, reservations, and miles
+
+int main(int argc, char *argv[])
+{
+    // Time the line reader
+    if (argc >= 2 && strcmp(argv[1], "--bench-reader") == 0)
+    {
+        benchmark_line_reader(argc >= 3 ? atol(argv[2]) : BENCHMARK_DEFAULT_RECORDS);
+        return 0;
+    }
+
+    // Generate a database of the given sizes
+    if (argc >= 2 && strcmp(argv[1], "--generate") == 0)
+    {
+        Workload workload;
+        if (argc < 3)
+        {
+            printf(RED "Oops! Please enter the directory to generate the database in.\n" RESET);
+            return EXIT_FAILURE;
+        }
+        return (parse_workload(argc, argv, 3, &workload) && generate_workload(argv[2], &workload)) ? 0 : EXIT_FAILURE;
+    }
+
+    // Benchmark bookings on many threads
+    if (argc >= 2 && strcmp(argv[1], "--bench-booking") == 0)
+    {
+        Workload workload;
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        int max_threads = (argc >= 3) ? atoi(argv[2]) : (int)((cores > BENCHMARK_MIN_THREADS) ? cores : BENCHMARK_MIN_THREADS);
+        if (max_threads < 1 || max_threads > BENCHMARK_MAX_THREADS)
+        {
+            printf(RED "Oops! The number of threads must be from 1 to %d.\n" RESET, BENCHMARK_MAX_THREADS);
+            return EXIT_FAILURE;
+        }
+        if (!parse_workload(argc, argv, 3, &workload))
+        {
+            return EXIT_FAILURE;
+        }
+        benchmark_booking(max_threads, &workload);
+        return 0;
+    }
+
+    // Benchmark a generated database
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0)
+    {
+        Workload workload;
+        if (!parse_workload(argc, argv, 2, &workload))
+        {
+            return EXIT_FAILURE;
+        }
+        benchmark_database(&workload);
+        return 0;
+    }
+
+    // Print how to run it
+    printf(RED "Oops! Please enter one of:\n" RESET);
+    printf("  bench --generate <directory> [flights] [passengers] [reservations] [airports]\n");
+    printf("  bench --bench [flights] [passengers] [reservations] [airports]\n");
+    printf("  bench --bench-booking [threads] [flights] [passengers] [reservations] [airports]\n");
+    printf("  bench --bench-reader [records]\n");
+    return EXIT_FAILURE;
+}
+
+void out_of_memory()
+{
+    // Called by the database when an allocation fails
+    printf(RED "Oops! Memory allocation failed.\n\n" RESET);
+    exit(EXIT_FAILURE);
+}
+
+void print_status(int status)
+{
+    // Print the message of the status code
+    printf(RED "Oops! %s\n\n" RESET, fdb_status_message(status));
+}
+
+void benchmark_line_reader(long records)
+{
+    // Variables
+    struct timespec begin, finish;
+    double read_line_seconds, line_reader_seconds;
+    long read_line_lines = 0, line_reader_lines = 0;
+    LineReader reader;
+    StringView line;
+
+    if (records <= 0)
+    {
+        printf(RED "Oops! The number of records must be at least 1.\n" RESET);
+        return;
+    }
+
+    // Generate a flights file in the format of save_flights()
+    FILE *fp = fopen(BENCHMARK_READER_FILE, "w");
+    if (fp == NULL)
+    {
+        printf(RED "Error creating %s\n" RESET, BENCHMARK_READER_FILE);
+        return;
+    }
+    fprintf(fp, "%ld\n", records);
+    for (long i = 0; i < records; i++)
+    {
+        int day = (int)(i % 28) + 1, month = (int)(i / 28 % 12), hours = (int)(i % 24), minutes = (int)(i % 60);
+        fprintf(fp, "F%05ld\nOrigin %ld\nDestination %ld\n", i % 100000, i % 300, (i + 1) % 300);
+        fprintf(fp, "%d %s 2030 - %02d:%02d\n", day, MONTHS[month], hours, minutes);
+        fprintf(fp, "%d %s 2030 - %02d:%02d\n", day, MONTHS[month], (hours + 1) % 24, minutes);
+        fprintf(fp, "%ld\n%d\n%ld\n", i % 50, 50, i % 500);
+    }
+    fclose(fp);
+    printf("Generated %ld flights in %s.\n", records, BENCHMARK_READER_FILE);
+
+    // Read every line with read_line() (what the menus' get_string() reads with)
+    fp = fopen(BENCHMARK_READER_FILE, "r");
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    while (true)
+    {
+        char *string = read_line(fp);
+        if (feof(fp) && string[0] == '\0')
+        {
+            free(string);
+            break;
+        }
+        read_line_lines++;
+        free(string);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    fclose(fp);
+    read_line_seconds = (finish.tv_sec - begin.tv_sec) + (finish.tv_nsec - begin.tv_nsec) / 1e9;
+
+    // Read every line with a LineReader (copying each line, like the loaders copy each string field)
+    fp = fopen(BENCHMARK_READER_FILE, "r");
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    line_reader_init(&reader, fp);
+    while (line_reader_next(&reader, &line))
+    {
+        line_reader_lines++;
+        free(string_view_copy(line));
+    }
+    free_line_reader(&reader);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    fclose(fp);
+    line_reader_seconds = (finish.tv_sec - begin.tv_sec) + (finish.tv_nsec - begin.tv_nsec) / 1e9;
+
+    // Print the results
+    printf("read_line():   %ld lines in %.3f s (%.1f ns/line)\n",
+           read_line_lines, read_line_seconds, read_line_seconds * 1e9 / read_line_lines);
+    printf("LineReader:    %ld lines in %.3f s (%.1f ns/line)\n",
+           line_reader_lines, line_reader_seconds, line_reader_seconds * 1e9 / line_reader_lines);
+    printf("Speedup:       %.2fx\n", read_line_seconds / line_reader_seconds);
+
+    remove(BENCHMARK_READER_FILE);
+}
+
+void benchmark_database(Workload *workload)
+{
+    // Variables
+    char directory[] = BENCHMARK_DIRECTORY;
+    char flight_id[FLIGHT_ID_STR_LEN + 1], passport_number[24]; // (long enough for any long, not only generated passport numbers)
+    char origin[4], destination[4];
+    double samples_seconds[BENCHMARK_LOAD_RUNS * 2 + BENCHMARK_RENDER_RUNS];
+    double *samples = NULL;
+    struct timespec begin, finish, total_begin;
+    unsigned long long state = GENERATE_SEED;
+    long found = 0;
+    LoadReport report;
+    Itinerary itinerary;
+    FlightDB *db = NULL;
+    int status;
+
+    fdb_set_memory_handler(out_of_memory);
+
+    // Generate the database in a temporary directory
+    if (mkdtemp(directory) == NULL)
+    {
+        printf(RED "Error creating %s\n" RESET, directory);
+        return;
+    }
+    if (!generate_workload(directory, workload))
+    {
+        remove_directory(directory);
+        return;
+    }
+    samples = (double *)malloc(sizeof(double) * BENCHMARK_SAMPLES);
+    if (samples == NULL) // If malloc failed
+    {
+        remove_directory(directory);
+        out_of_memory();
+    }
+
+    printf("\n%-22s %8s %12s %12s %16s\n", "Operation", "Runs", "p50", "p99", "Throughput");
+
+    // Load from the text files (every run starts from a new database)
+    clock_gettime(CLOCK_MONOTONIC, &total_begin);
+    for (int run = 0; run < BENCHMARK_LOAD_RUNS; run++)
+    {
+        fdb_close(db);
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        db = fdb_create(directory);
+        status = fdb_load(db, &report);
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        samples_seconds[run] = elapsed_seconds(begin, finish);
+        if (status != FDB_OK)
+        {
+            print_status(status);
+            fdb_close(db);
+            free(samples);
+            remove_directory(directory);
+            return;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    benchmark_report("load (text files)", samples_seconds, BENCHMARK_LOAD_RUNS, elapsed_seconds(total_begin, finish));
+
+    // Save a new generation (text files and snapshot)
+    clock_gettime(CLOCK_MONOTONIC, &total_begin);
+    for (int run = 0; run < BENCHMARK_LOAD_RUNS; run++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        status = fdb_save(db);
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        samples_seconds[run] = elapsed_seconds(begin, finish);
+        if (status != FDB_OK)
+        {
+            print_status(status);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    benchmark_report("save", samples_seconds, BENCHMARK_LOAD_RUNS, elapsed_seconds(total_begin, finish));
+
+    // Load again, now from the snapshot the saves wrote
+    clock_gettime(CLOCK_MONOTONIC, &total_begin);
+    for (int run = 0; run < BENCHMARK_LOAD_RUNS; run++)
+    {
+        fdb_close(db);
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        db = fdb_create(directory);
+        status = fdb_load(db, &report);
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        samples_seconds[run] = elapsed_seconds(begin, finish);
+        if (status != FDB_OK)
+        {
+            print_status(status);
+            fdb_close(db);
+            free(samples);
+            remove_directory(directory);
+            return;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    benchmark_report("load (snapshot)", samples_seconds, BENCHMARK_LOAD_RUNS, elapsed_seconds(total_begin, finish));
+
+    // Search for random flight IDs (about one in ten is not in the database)
+    clock_gettime(CLOCK_MONOTONIC, &total_begin);
+    for (long i = 0; i < BENCHMARK_SAMPLES; i++)
+    {
+        generated_flight_id((long)(next_random(&state) % (workload->flights + workload->flights / 10 + 1)) % GENERATE_MAX_FLIGHTS, flight_id);
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        Flight *flight = fdb_find_flight(db, flight_id);
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        samples[i] = elapsed_seconds(begin, finish);
+        found += (flight != NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    benchmark_report("search flight", samples, BENCHMARK_SAMPLES, elapsed_seconds(total_begin, finish));
+
+    // Search random routes for the Flights of a random day (the search view_flights() mode 5 makes)
+    Flight *first_flight = fdb_flights(db);
+    if (first_flight == NULL)
+    {
+        printf(RED "Oops! The generated database has no Flights.\n" RESET);
+        fdb_close(db);
+        free(samples);
+        remove_directory(directory);
+        return;
+    }
+    long long first_departure = first_flight->departure_minutes;
+    clock_gettime(CLOCK_MONOTONIC, &total_begin);
+    for (long i = 0; i < BENCHMARK_SAMPLES; i++)
+    {
+        generated_airport((int)(next_random(&state) % workload->airports), workload->airports, origin);
+        generated_airport((int)(next_random(&state) % workload->airports), workload->airports, destination);
+        long long day_start = first_departure + (long long)(next_random(&state) % 365) * 24 * 60;
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        RouteView route = fdb_search_route(db, origin, destination, day_start);
+        for (int j = 0; j < route.count && route.flights[j]->departure_minutes < day_start + 24 * 60; j++)
+        {
+            found++;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        samples[i] = elapsed_seconds(begin, finish);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    benchmark_report("search route (a day)", samples, BENCHMARK_SAMPLES, elapsed_seconds(total_begin, finish));
+
+    // Find itineraries between random airports from a random day (the search find_itinerary() makes)
+    clock_gettime(CLOCK_MONOTONIC, &total_begin);
+    for (long i = 0; i < BENCHMARK_ITINERARIES; i++)
+    {
+        generated_airport((int)(next_random(&state) % workload->airports), workload->airports, origin);
+        generated_airport((int)(next_random(&state) % workload->airports), workload->airports, destination);
+        long long day_start = first_departure + (long long)(next_random(&state) % 365) * 24 * 60;
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        found += (fdb_find_itinerary(db, origin, destination, day_start, NULL, &itinerary) == FDB_OK);
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        samples[i] = elapsed_seconds(begin, finish);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    benchmark_report("find itinerary", samples, BENCHMARK_ITINERARIES, elapsed_seconds(total_begin, finish));
+
+    // Check random Flights against random Passengers' schedules (the check book_reservation() makes)
+    long checks = 0;
+    clock_gettime(CLOCK_MONOTONIC, &total_begin);
+    for (long i = 0; i < BENCHMARK_SAMPLES && workload->passengers > 0; i++)
+    {
+        snprintf(passport_number, sizeof(passport_number), "P%08ld", (long)(next_random(&state) % workload->passengers));
+        generated_flight_id((long)(next_random(&state) % workload->flights), flight_id);
+        Passenger *passenger = fdb_find_passenger(db, passport_number);
+        Flight *flight = fdb_find_flight(db, flight_id);
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        Flight *conflict = fdb_find_conflict(db, passenger, flight);
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        samples[checks++] = elapsed_seconds(begin, finish);
+        found += (conflict != NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    if (checks > 0)
+    {
+        benchmark_report("conflict check", samples, checks, elapsed_seconds(total_begin, finish));
+    }
+
+    // Format the listings to /dev/null (the rows are still formatted and written)
+    FILE *null_fp = fopen("/dev/null", "w");
+    if (null_fp == NULL)
+    {
+        printf(RED "Error opening /dev/null, so the listings are not timed\n" RESET);
+    }
+    else
+    {
+        setvbuf(null_fp, NULL, _IOFBF, BENCHMARK_OUTPUT_SIZE);
+        for (int available = 1; available >= 0; available--)
+        {
+            clock_gettime(CLOCK_MONOTONIC, &total_begin);
+            for (int run = 0; run < BENCHMARK_RENDER_RUNS; run++)
+            {
+                clock_gettime(CLOCK_MONOTONIC, &begin);
+                benchmark_listing(db, available, null_fp);
+                clock_gettime(CLOCK_MONOTONIC, &finish);
+                samples_seconds[run] = elapsed_seconds(begin, finish);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &finish);
+            benchmark_report(available ? "list available flights" : "list all flights",
+                             samples_seconds, BENCHMARK_RENDER_RUNS, elapsed_seconds(total_begin, finish));
+        }
+        fclose(null_fp);
+    }
+
+    // Keep the results from being optimized away, then clean up
+    printf("\n%ld searches and conflict checks found a Flight.\n", found);
+    fdb_close(db);
+    free(samples);
+    remove_directory(directory);
+}
+
+void benchmark_listing(FlightDB *db, bool available, FILE *fp)
+{
+    // Variables
+    int position = 0;
+    const ColumnWidths *widths = fdb_column_widths(db, available);
+    Flight *ptr = available ? fdb_available_flight(db, 0) : fdb_flights(db);
+
+    // The column widths are kept up to date as Flights change, so the rows are formatted in one pass
+    int max_origin_length = column_width(widths->origin);
+    int max_destination_length = column_width(widths->destination);
+    int max_departure_month_length = column_width(widths->departure_month);
+    int max_arrival_month_length = column_width(widths->arrival_month);
+
+    // Format every row of the listing (the bookable Flights or every Flight), like view_flights_linear() does
+    while (ptr != NULL)
+    {
+        fprintf(fp, "%6s | %-*s to %-*s | %02d %-*s %02d %02d:%02d - %02d %-*s %02d %02d:%02d\n",
+                ptr->flight_id, max_origin_length, ptr->origin, max_destination_length, ptr->destination,
+                ptr->departure.date.day, max_departure_month_length, int_to_month(ptr->departure.date.month), ptr->departure.date.year,
+                ptr->departure.time.hours, ptr->departure.time.minutes,
+                ptr->arrival.date.day, max_arrival_month_length, int_to_month(ptr->arrival.date.month), ptr->arrival.date.year,
+                ptr->arrival.time.hours, ptr->arrival.time.minutes);
+        ptr = available ? fdb_available_flight(db, ++position) : ptr->next;
+    }
+    fflush(fp);
+}
+
+void remove_directory(char *directory)
+{
+    // Variables
+    char filename[MAX_FILENAME_LENGTH];
+    struct dirent *entry;
+
+    // Delete every file in it, then the directory itself
+    DIR *dir = opendir(directory);
+    if (dir == NULL)
+    {
+        return;
+    }
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+        {
+            if (snprintf(filename, MAX_FILENAME_LENGTH, "%s/%s", directory, entry->d_name) < MAX_FILENAME_LENGTH)
+            {
+                unlink(filename);
+            }
+        }
+    }
+    closedir(dir);
+    rmdir(directory);
+}
+
+void benchmark_booking(int max_threads, Workload *workload)
+{
+    // Variables
+    char directory[] = BENCHMARK_DIRECTORY;
+    char journal_filename[MAX_FILENAME_LENGTH];
+    pthread_t threads[BENCHMARK_MAX_THREADS];
+    BookingWorker workers[BENCHMARK_MAX_THREADS];
+    struct timespec begin, finish;
+    double single_thread_rate = 0;
+    LoadReport report;
+
+    fdb_set_memory_handler(out_of_memory);
+
+    // Generate the database in a temporary directory
+    if (mkdtemp(directory) == NULL)
+    {
+        printf(RED "Error creating %s\n" RESET, directory);
+        return;
+    }
+    if (workload->passengers == 0 || !generate_workload(directory, workload))
+    {
+        if (workload->passengers == 0)
+        {
+            printf(RED "Oops! The number of passengers must be at least 1.\n" RESET);
+        }
+        remove_directory(directory);
+        return;
+    }
+    snprintf(journal_filename, MAX_FILENAME_LENGTH, "%s/%s", directory, JOURNAL_FILE);
+
+    printf("\n%ld cores online, %d bookings per run.\n", sysconf(_SC_NPROCESSORS_ONLN), BENCHMARK_BOOKINGS);
+    printf("\n%-8s %10s %10s %10s %10s %16s %8s %10s\n", "Threads", "Booked", "Cancelled", "Refused", "Time", "Throughput", "Speedup", "Check");
+
+    for (int thread_count = 1; thread_count <= max_threads; thread_count = (thread_count * 2 > max_threads && thread_count < max_threads) ? max_threads : thread_count * 2)
+    {
+        // Every run starts from the generated files (the last run's journal is thrown away)
+        unlink(journal_filename);
+        FlightDB *db = fdb_create(directory);
+        int status = fdb_load(db, &report);
+        if (status != FDB_OK)
+        {
+            print_status(status);
+            fdb_close(db);
+            break;
+        }
+
+        // The journal is synced once at the end, so the threads only share the (short) journal lock
+        fdb_begin_batch(db);
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        for (int i = 0; i < thread_count; i++)
+        {
+            workers[i] = (BookingWorker){.db = db, .workload = workload, .operations = BENCHMARK_BOOKINGS / thread_count,
+                                         .seed = GENERATE_SEED + 7919ULL * (i + 1), .booked = 0, .cancelled = 0, .refused = 0};
+            if (pthread_create(&threads[i], NULL, booking_worker, &workers[i]) != 0)
+            {
+                printf(RED "Oops! Could not start thread %d.\n" RESET, i + 1);
+                thread_count = i;
+                break;
+            }
+        }
+        long booked = 0, cancelled = 0, refused = 0;
+        for (int i = 0; i < thread_count; i++)
+        {
+            pthread_join(threads[i], NULL);
+            booked += workers[i].booked;
+            cancelled += workers[i].cancelled;
+            refused += workers[i].refused;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &finish);
+        fdb_end_batch(db);
+
+        // Report the run (speedup is against one thread)
+        double seconds = elapsed_seconds(begin, finish);
+        double rate = (booked + cancelled + refused) / seconds;
+        if (thread_count == 1)
+        {
+            single_thread_rate = rate;
+        }
+        printf("%-8d %10ld %10ld %10ld %8.3f s %12.1f op/s %7.2fx %10s\n", thread_count, booked, cancelled, refused, seconds, rate,
+               rate / single_thread_rate, (check_bookings(db) && check_journal(db, directory)) ? "ok" : "MISMATCH");
+
+        fdb_close(db);
+        if (thread_count == 0)
+        {
+            break;
+        }
+    }
+
+    remove_directory(directory);
+}
+
+void *booking_worker(void *arg)
+{
+    // Variables
+    BookingWorker *worker = (BookingWorker *)arg;
+    char flight_id[FLIGHT_ID_STR_LEN + 1], passport_number[24]; // (long enough for any long, not only generated passport numbers)
+    unsigned long long state = worker->seed;
+
+    // Book random Flights for random Passengers (refusals are part of the workload), and cancel some of them again
+    for (long i = 0; i < worker->operations; i++)
+    {
+        snprintf(passport_number, sizeof(passport_number), "P%08ld", (long)(next_random(&state) % worker->workload->passengers));
+        generated_flight_id((long)(next_random(&state) % worker->workload->flights), flight_id);
+        if (fdb_book(worker->db, passport_number, flight_id) != FDB_OK)
+        {
+            worker->refused++;
+        }
+        else if (next_random(&state) % 4 == 0 && fdb_cancel(worker->db, passport_number, flight_id) == FDB_OK)
+        {
+            worker->cancelled++;
+        }
+        else
+        {
+            worker->booked++;
+        }
+    }
+
+    return NULL;
+}
+
+bool check_bookings(FlightDB *db)
+{
+    // Variables
+    long long booked_seats = 0, reservations = 0;
+
+    // Every Flight's passenger count must match its manifest and fit its seats
+    for (Flight *flight = fdb_flights(db); flight != NULL; flight = flight->next)
+    {
+        int manifest_count = 0;
+        for (Reservation *r_ptr = flight->manifest; r_ptr != NULL; r_ptr = r_ptr->manifest_next)
+        {
+            manifest_count++;
+        }
+        if (manifest_count != flight->passenger_qty || flight->passenger_qty > flight->passenger_max)
+        {
+            return false;
+        }
+        booked_seats += flight->passenger_qty;
+    }
+
+    // And every reservation must be counted once
+    for (Passenger *passenger = fdb_passengers(db); passenger != NULL; passenger = passenger->next)
+    {
+        reservations += passenger->reservation_qty;
+    }
+    return booked_seats == reservations;
+}
+
+bool check_journal(FlightDB *db, char *directory)
+{
+    // Variables
+    LoadReport report;
+    bool same = true;
+
+    // Load the run's journal into a second database (every change must replay, in the order it was journaled)
+    FlightDB *replayed = fdb_create(directory);
+    if (fdb_load(replayed, &report) != FDB_OK || report.journal_status != FDB_OK || report.skipped > 0)
+    {
+        fdb_close(replayed);
+        return false;
+    }
+
+    // Both lists are in the same order, so the records are compared side by side
+    Flight *flight = fdb_flights(db), *replayed_flight = fdb_flights(replayed);
+    for (; same && flight != NULL && replayed_flight != NULL; flight = flight->next, replayed_flight = replayed_flight->next)
+    {
+        same = strcmp(flight->flight_id, replayed_flight->flight_id) == 0 && flight->passenger_qty == replayed_flight->passenger_qty;
+    }
+    same = same && flight == NULL && replayed_flight == NULL;
+
+    Passenger *passenger = fdb_passengers(db), *replayed_passenger = fdb_passengers(replayed);
+    for (; same && passenger != NULL && replayed_passenger != NULL; passenger = passenger->next, replayed_passenger = replayed_passenger->next)
+    {
+        same = strcmp(passenger->passport_number, replayed_passenger->passport_number) == 0 &&
+               passenger->reservation_qty == replayed_passenger->reservation_qty && passenger->miles == replayed_passenger->miles;
+    }
+    same = same && passenger == NULL && replayed_passenger == NULL;
+
+    fdb_close(replayed);
+    return same;
+}
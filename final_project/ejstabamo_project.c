@@ -2,12 +2,15 @@
     Final Project - Flight Passenger Management System
 */
 
+#include "flightdb.h"
+
 #include <ctype.h>
-#include <stdbool.h>
-#include <stdio.h>
+#include <limits.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 /* ANSI Color Codes - https://gist.github.com/RabaDabaDoba/145049536f815903c79944599c6f952a */
 
@@ -18,233 +21,152 @@
 #define B_CYAN "\e[1;36m"
 #define RESET "\e[0m"
 
-/* Global Constants/Definitions
+/* Global Constants/Definitions (the database's own are in flightdb.h)
     - STR_LEN means is for a strlen(), without the NUL terminator.
     - SIZE means is for a size, like an array/string, which (for a string) will include the NUL terminator.
 */
 
-#define FLIGHT_ID_STR_LEN 6    // the strlen() of a flight ID
-#define PASSPORT_NUM_STR_LEN 9 // the strlen() of a passport number
-
-#define MONTH_STR_SIZE 10      // the maximum array size of a month string (September is the longest string)
-#define INITIAL_BUFFER_SIZE 16 // the initial number of bytes allocated for a string
-
-#define MIN_PASSENGERS_PER_FLIGHT 1         // the minimum number of passengers allowed for a flight
-#define MAX_AGE 130                         // the maximum age allowed for a passenger
-#define MIN_FLIGHT_DURATION_IN_MINUTES 1    // the minimum flight duration allowed for a flight
-#define MAX_FLIGHT_DURATION_IN_MINUTES 1130 // the maximum flight duration allowed for a flight (from Singapore (SIN) to New York (JFK))
-#define VIEW_FLIGHTS_LINEAR_AVAILABLE 1     // the mode for viewing available flights in view_flights_linear()
-#define VIEW_FLIGHTS_LINEAR_REMOVABLE 2     // the mode for viewing removable flights in view_flights_linear()
-#define VIEW_FLIGHTS_LINEAR_ALL 3           // the mode for viewing all flights in view_flights_linear()
-
-#define FLIGHTS_FILE "flights.txt"       // the string representing the file where flights are saved
-#define PASSENGERS_FILE "passengers.txt" // the string representing the file where passengers are saved
-#define MAX_BACKUPS 2                    // the maximum number of backups allowed
-#define MAX_FILENAME_LENGTH 256          // the maximum length of a filename
+#define BATCH_MAX_FIELDS 9     // the maximum number of fields of a batch command (including the command name)
+#define BATCH_ADD_FLIGHT 0     // the batch command for add_flight()
+#define BATCH_EDIT_FLIGHT 1    // the batch command for edit_flight()
+#define BATCH_DELETE_FLIGHT 2  // the batch command for delete_flight()
+#define BATCH_ADD_PASSENGER 3  // the batch command for add_passenger()
+#define BATCH_EDIT_PASSENGER 4 // the batch command for edit_passenger()
+#define BATCH_BOOK 5           // the batch command for book_reservation()
+#define BATCH_CANCEL 6         // the batch command for remove_reservation()
+#define BATCH_COMMAND_COUNT 7  // the number of batch commands
 
-const char *MONTHS[12] = {"January", "February", "March", "April", // an array of month strings
-                          "May", "June", "July", "August",
-                          "September", "October", "November", "December"};
+#define VIEW_FLIGHTS_LINEAR_AVAILABLE 1 // the mode for viewing available flights in view_flights_linear()
+#define VIEW_FLIGHTS_LINEAR_REMOVABLE 2 // the mode for viewing removable flights in view_flights_linear()
+#define VIEW_FLIGHTS_LINEAR_ALL 3       // the mode for viewing all flights in view_flights_linear()
+#define OUTPUT_BUFFER_SIZE (64 * 1024)  // the number of bytes an output buffer holds before it is written
+#define LISTING_PAGE_LINES 40           // the number of lines shown before a listing pauses (only on a terminal)
 
-/* Structures */
+const char *BATCH_COMMANDS[BATCH_COMMAND_COUNT] = {"add-flight", "edit-flight", "delete-flight", // the name of each batch command
+                                                   "add-passenger", "edit-passenger",
+                                                   "book", "cancel"};
 
-typedef struct Date // A structure for a Date with the day, month, and year components.
-{
-    int day;                    // An int for the Day component of a Date.
-    char month[MONTH_STR_SIZE]; // A str for the Month component of a Date.
-    int year;                   // An int for the Year component of a Date.
-} Date;
+const int BATCH_COMMAND_FIELDS[BATCH_COMMAND_COUNT] = {8, 5, 1, 5, 3, 2, 2}; // the number of fields of each batch command (after its name)
 
-typedef struct Time // A structure for a Time with the hours and minutes components.
-{
-    int hours;   // An int for the Hours component of a Time.
-    int minutes; // An int for the Minutes component of a Time.
-} Time;
+/* Structures (the database's own are in flightdb.h) */
 
-typedef struct DateTime // A structure for a DateTime with a Date and Time.
+typedef struct OutputBuffer // A buffer the rows of a listing are formatted into before they are written at once.
 {
-    struct Date date; // A Date struct for the Date component
-    struct Time time; // A Time struct for the Time component
-} DateTime;
-
-typedef struct Flight // A structure for a Flight with Flight details.
-{
-    char *flight_id;           // A str for the Flight's flight_id
-    char *destination;         // A str for the Flight's destination country
-    char *origin;              // A str for the Flight's origin country
-    struct DateTime departure; // A DateTime for the Flight's departure
-    struct DateTime arrival;   // A DateTime for the Flight's arrival
-    int passenger_qty;         // An int for the Flight's current number of passengers
-    int passenger_max;         // An int for the Flight's maximum number of passengers allowed
-    int bonus_miles;           // An int for the number of bonus miles a passenger gets for booking the flight
-    struct Flight *prev;       // A ptr to the previous Flight node
-    struct Flight *next;       // A ptr to the next Flight node
-} Flight;
-
-typedef struct Reservation // A structure for a Reservation with a Flight.
-{
-    struct Flight *flight;    // A ptr to the Flight reserved
-    struct Reservation *prev; // A ptr to the previous Reservation node
-    struct Reservation *next; // A ptr to the next Reservation node
-} Reservation;
-
-typedef struct Passenger // A structure for a Passenger with passenger details.
-{
-    char *first_name;                 // A str for the Passenger's first name
-    char *last_name;                  // A str for the Passenger's last name
-    struct Date birth_date;           // A Date for the Passenger's birth date
-    char *passport_number;            // A str for the Passenger's passport number
-    int miles;                        // An int for the Passenger's number of miles accumulated
-    int reservation_qty;              // An int for the Passenger's number of reservations
-    struct Reservation *reservations; // A ptr to the Passenger's (linked) list of reservations
-    struct Passenger *prev;           // A ptr to the previous Passenger node
-    struct Passenger *next;           // A ptr to the next Passenger node
-} Passenger;
-
-typedef struct FlightStatus
-{
-    bool flight_departed; // A boolean indicating if a flight has departed.
-    bool flight_arrived;  // A boolean indicating if a flight has arrived.
-} FlightStatus;
+    char *data;      // A str for the formatted output (not NUL-terminated)
+    size_t size;     // A size_t for the number of bytes formatted
+    size_t capacity; // A size_t for the number of bytes allocated (OUTPUT_BUFFER_SIZE unless a string was longer)
+    int lines;       // An int for the number of lines formatted since the last page
+    bool paging;     // A boolean indicating if the output pauses after every page (only on a terminal)
+    bool stopped;    // A boolean indicating if the user stopped the output
+} OutputBuffer;
 
 /* General Helper Functions */
 
-int main_menu();                   // Prints a menu and returns an integer of the user's choice
+int main_menu(FlightDB *db);       // Prints a menu and returns an integer of the user's choice
 bool confirm_delete(char *prompt); // Asks the user if they are sure of deleting data
-void clean_exit();                 // Cleanly exits the program when there is no more memory left
-void update_current_datetime();    // Updates the current date and time
-
-/* String Helper Functions */
-
-char *toupper_string(char *string);    // Converts a string to uppercase
-char *capitalize_string(char *string); // Capitalizes a string
-
-/* Flight Status Functions */
-
-FlightStatus retrieve_flight_status(Flight *flight); // Gets the status of a flight
-
-/* Comparison Helper Functions */
-
-int flight_compare(Flight *a, Flight *b);          // Compares two flights
-int passenger_compare(Passenger *a, Passenger *b); // Compares two passengers
-
-/* Validation Helper Functions */
-
-bool is_valid_day(int day, char *month, int year); // Checks if a day is valid
-bool is_valid_month(char *input);                  // Checks if a month is valid
-bool is_valid_nonempty_string(char *string);       // Checks if a string is valid (nonempty)
-bool is_valid_id(char *id);                        // Checks if an ID is valid
-bool is_valid_passport(char *passport_number);     // Checks if a passport is valid
-
-/* DateTime Helper Functions */
-
-int month_to_int(char *month);                                        // Converts a month string to its number
-long long datetime_to_minutes(DateTime dt);                           // Converts a DateTime to minutes
-int days_in_month(char *month, int year);                             // Gets the number of days in a month
-DateTime compute_arrival_datetime(DateTime departure, Time duration); // Gets an arrival DateTime from a departure DateTime and duration
-
-/* DateTime Check Helper Functions */
-
-bool is_conflicting(DateTime departure1, DateTime arrival1, // Checks if a DateTime is in the bounds of another DateTime
-                    DateTime departure2, DateTime arrival2);
-bool is_leap(int year);                         // Checks if a year is a leap year
-bool is_future(DateTime date1, DateTime date2); // Checks if a DateTime is in the future (from another DateTime)
-bool is_valid_birthdate(Date birth_date);       // Checks if a birth date is valid
+void clean_exit();                 // Cleanly exits the program (closing the database)
+void out_of_memory();              // Cleanly exits the program when there is no more memory left
+void print_status(int status);     // Prints the message of a status code a change was refused with
 
 /* Input Functions */
 
-char *get_string(char *prompt, FILE *stream);  // Prompts a user for a string or gets a string from a file (with automatic dynamic memory allocation)
-int get_int(char *prompt);                     // Prompts a user for an integer
-Date get_date(char *prompt);                   // Prompts a user for a Date (for DateTimes, birthdays)
-Time get_time(char *prompt, bool is_duration); // Prompts a user for a Time (for DateTimes, durations)
-DateTime get_departure_datetime(char *prompt); // Prompts a user for a departure DateTime
-
-/* Free Memory Functions */
-
-void free_flight_node(Flight *node);            // Frees memory allocated for a Flight node
-void free_passenger_node(Passenger *node);      // Frees memory allocated for a Passenger node
-void free_flights_list(Flight *head);           // Frees all memory allocated for the flights linked list
-void free_passengers_list(Passenger *head);     // Frees all memory allocated for the passengers linked list
-void free_reservations_list(Reservation *head); // Frees all memory allocated for the reservations linked list
-
-/* Flight Linked List Functions */
-
-Flight *create_flight_node();                              // Creates a Flight node
-Flight *search_flight_node(Flight *head, char *flight_id); // Searches for a Flight in the linked list and returns a pointer to it
-void insert_flight_node(Flight **head, Flight *node);      // Insert a Flight to the linked list considering order
-void reinsert_flight_node(Flight **head, Flight *node);    // Reinserts a Flight to the linked list (ensures order of data is maintained after editing a node)
-void delete_flight_node(Flight **head, char *flight_id);   // Deletes a Flight from the linked list
-int count_flights(Flight *head);                           // Counts the number of Flights in the linked list
-
-/* Passenger Linked List Functions */
-
-Passenger *create_passenger_node();                                       // Creates a Passenger Node
-Passenger *search_passenger_node(Passenger *head, char *passport_number); // Searches for a Passenger in the linked list and returns a pointer to it
-void insert_passenger_node(Passenger **head, Passenger *node);            // Insert a Passenger to the linked list considering order
-int count_passengers(Passenger *head);                                    // Counts the number of Passengers in the linked list
+char *get_string(char *prompt, FILE *stream);               // Prompts a user for a string or gets a string from a file (with automatic dynamic memory allocation)
+int get_int(char *prompt);                                  // Prompts a user for an integer
+Date get_date(char *prompt);                                // Prompts a user for a Date (for DateTimes, birthdays)
+Time get_time(char *prompt, bool is_duration);              // Prompts a user for a Time (for DateTimes, durations)
+DateTime get_departure_datetime(FlightDB *db, char *prompt); // Prompts a user for a departure DateTime
 
-/* Reservation Linked List Functions */
+/* Output Buffer Functions */
 
-Reservation *create_reservation_node(Flight *flight);                    // Creates a Reservation Node
-Reservation *search_reservation_node(Reservation *head, Flight *flight); // Searches for a Reservation in the linked list and returns a pointer to it
-void insert_reservation_node(Reservation **head, Reservation *node);     // Insert a Reservation to the linked list considering order
-void delete_reservation_node(Reservation **head, Flight *flight);        // Deletes a Reservation from the linked list
-int count_reservations(Reservation *head);                               // Counts the number of Reservations in the linked list
+void output_init(OutputBuffer *out);                            // Initializes an empty OutputBuffer (paging only on a terminal)
+void output_printf(OutputBuffer *out, const char *format, ...); // Formats a string to the end of an OutputBuffer (writing it first if it is full)
+void output_page(OutputBuffer *out);                            // Pauses the output after a full page (the user can stop it)
+void output_flush(OutputBuffer *out);                           // Writes an OutputBuffer to stdout with one fwrite() and empties it
+void free_output_buffer(OutputBuffer *out);                     // Frees all memory allocated for an OutputBuffer
 
 /* Program Functionality */
 
-void add_flight(Flight **head);                             // Adds a Flight to the database
-void edit_flight(Flight **head);                            // Edits a Flight in the database
-int view_flights_menu();                                    // Prints the menu for viewing flights and returns an integer
-void view_flights(Flight *head, int mode);                  // Views flights in the database
-void delete_flight(Flight **f_head, Passenger *p_head);     // Deletes a Flight from the database
-void add_passenger(Passenger **head);                       // Adds a passenger to the database
-void edit_passenger(Passenger *head);                       // Edits a passenger in the database
-void book_reservation(Flight *f_head, Passenger *p_head);   // Books a Flight reservation for a passenger
-void remove_reservation(Flight *f_head, Passenger *p_head); // Removes a Flight reservation from a passenger
-void view_reservations(Passenger *p_head);                  // Views all reservations of a passenger
+void add_flight(FlightDB *db);                    // Adds a Flight to the database
+void edit_flight(FlightDB *db);                   // Edits a Flight in the database
+int view_flights_menu();                          // Prints the menu for viewing flights and returns an integer
+void view_flights(FlightDB *db, int mode);        // Views flights in the database
+void find_itinerary(FlightDB *db);                // Views the bookable Flights (with connections) that reach a destination the earliest
+void delete_flight(FlightDB *db);                 // Deletes a Flight from the database
+void add_passenger(FlightDB *db);                 // Adds a passenger to the database
+void edit_passenger(FlightDB *db);                // Edits a passenger in the database
+void book_reservation(FlightDB *db);              // Books a Flight reservation for a passenger
+void remove_reservation(FlightDB *db);            // Removes a Flight reservation from a passenger
+void view_reservations(FlightDB *db);             // Views all reservations of a passenger
+void print_removed_reservations(Flight *flight); // Prints the reservations deleting an (arrived) Flight removes
 
 /* Linear View / Print Functions */
 
-bool view_flights_linear(Flight *head, int mode); // Views flights in the database (linear format), returns false if no flights can be printed
-void view_passengers_linear(Passenger *head);     // Views passengers in the database (linear format)
-void view_reservations_linear(Reservation *head); // Views reservations for a passenger (linear format)
-void print_flight(Flight *flight);                // Prints all details of a Flight
-void print_passenger(Passenger *passenger);       // Prints all details of a Passenger
+bool view_flights_linear(FlightDB *db, int mode);                   // Views flights in the database (linear format), returns false if no flights can be printed
+void view_passengers_linear(Passenger *head);                       // Views passengers in the database (linear format)
+void view_reservations_linear(Reservation *head);                   // Views reservations for a passenger (linear format)
+void print_flight(FlightDB *db, Flight *flight);                    // Prints all details of a Flight
+void render_flight(FlightDB *db, OutputBuffer *out, Flight *flight); // Formats all details of a Flight to an OutputBuffer
+void print_passenger(Passenger *passenger);                         // Prints all details of a Passenger
+void view_manifest_linear(Flight *flight);                          // Views the passengers booked on a Flight (linear format)
 
-/* File Functions */
+/* Batch Functions */
 
-void load_flights(Flight **f_head, FILE *fp);                           // Load flights from a file
-void load_passengers(Flight *f_head, Passenger **p_head, FILE *fp);     // Load passengers from a file
-void load(Flight **f_head, Passenger **p_head);                         // Load flights and passengers
-void save_flights(Flight *f_head, FILE *fp);                            // Save flights to a file
-void save_passengers(Passenger *p_head, FILE *fp);                      // Save passengers to a file
-void save(Flight *f_head, Passenger *p_head);                           // Save flights and passengers
-void create_backups(char *flights_filename, char *passengers_filename); // Create backups of files
-bool file_exists(char *filename);                                       // Check if a file exists
+void run_batch(FlightDB *db, char *filename);                                 // Runs every command of a batch file (stdin if there is none) and reports the throughput
+bool batch_apply(FlightDB *db, int command, char **fields, int line_number); // Runs one batch command without prompts (false if it was refused)
+bool batch_error(int line_number, const char *format, ...);                   // Prints why a batch command was refused (always false)
+bool parse_batch_date(char *string, Date *date);                              // Parses a YYYY-MM-DD date
+bool parse_batch_time(char *string, Time *time);                              // Parses an HH:MM time
+bool parse_batch_int(char *string, int *value);                               // Parses a whole string as an int
 
-/* Global Linked Lists */
+/* Global Database */
 
-Flight *flights = NULL;       // Global Flights Linked List
-Passenger *passengers = NULL; // Global Passengers Linked List
+FlightDB *database = NULL; // Global Database of Flights, Passengers, and Reservations (closed by clean_exit())
 
-/* Global Time */
-
-DateTime current_datetime; // Global Current DateTime
-
-int main()
+int main(int argc, char *argv[])
 {
     // Variables
-    int choice, view_choice;
+    int choice = -1, view_choice, status;
+    bool batch_mode = argc >= 2 && strcmp(argv[1], "--batch") == 0;
+    LoadReport report;
 
-    // Load Flights and Passengers from files
-    load(&flights, &passengers);
+    // Open the database in the current directory (it reads the clock before loading)
+    fdb_set_memory_handler(out_of_memory);
+    database = fdb_create(NULL);
+
+    // Load Flights and Passengers from files and replay the journal
+    if ((status = fdb_load(database, &report)) != FDB_OK)
+    {
+        printf(RED "Oops! %s\nCannot continue.\n" RESET, fdb_status_message(status));
+        printf(BLUE "Info: This may have happened because files were edited manually.\n\n" RESET);
+        clean_exit();
+    }
+    if (report.journal_status != FDB_OK)
+    {
+        printf(RED "Oops! %s\n" RESET, fdb_status_message(report.journal_status));
+    }
+    if (report.replayed > 0)
+    {
+        printf(BLUE "Info: Replayed %d change(s) from %s.\n" RESET, report.replayed, JOURNAL_FILE);
+    }
+    if (report.skipped > 0)
+    {
+        printf(RED "Oops! %d change(s) in %s did not fit the saved data and were skipped.\n" RESET, report.skipped, JOURNAL_FILE);
+    }
+
+    // Run the commands of a batch file (or a pipe) instead of the menus
+    if (batch_mode)
+    {
+        run_batch(database, (argc >= 3) ? argv[2] : NULL);
+    }
 
     // Main Program Loop
-    do
+    while (!batch_mode && choice != 0)
     {
         // Print the menu and ask the user for a choice
-        choice = main_menu();
+        choice = main_menu(database);
+
+        // Read the clock once for the whole command (every Flight Status is checked against it)
+        fdb_update_time(database);
 
         printf("\n");
 
@@ -253,12 +175,12 @@ int main()
         {
         // Add Flight
         case 1:
-            add_flight(&flights);
+            add_flight(database);
             break;
 
         // Edit Flight
         case 2:
-            edit_flight(&flights);
+            edit_flight(database);
             break;
 
         // View Flights
@@ -266,8 +188,9 @@ int main()
             // Enter a submenu loop
             do
             {
-                // Print the menu and ask the user for a choice
+                // Print the menu and ask the user for a choice (and read the clock once for the listing)
                 view_choice = view_flights_menu();
+                fdb_update_time(database);
                 printf("\n");
                 switch (view_choice)
                 {
@@ -276,7 +199,9 @@ int main()
                 case 2:
                 case 3:
                 case 4:
-                    view_flights(flights, view_choice);
+                case 5:
+                case 6:
+                    view_flights(database, view_choice);
                     break;
                 // Return to the main menu
                 case 0:
@@ -290,38 +215,37 @@ int main()
 
         // Delete Flight
         case 4:
-            delete_flight(&flights, passengers);
+            delete_flight(database);
             break;
 
         // Add Passenger
         case 5:
-            add_passenger(&passengers);
+            add_passenger(database);
             break;
 
         // Edit Passenger
         case 6:
-            edit_passenger(passengers);
+            edit_passenger(database);
             break;
 
         // Book Reservation
         case 7:
-            book_reservation(flights, passengers);
+            book_reservation(database);
             break;
 
         // Remove Reservation
         case 8:
-            remove_reservation(flights, passengers);
+            remove_reservation(database);
             break;
 
         // View Reservation
         case 9:
-            view_reservations(passengers);
+            view_reservations(database);
             break;
 
         // Exit
         case 0:
-            // Save Flights and Passengers to Files
-            save(flights, passengers);
+            // Every change is already in the journal, so there is nothing to save
 
             // Print a Goodbye message
             printf(YELLOW "Goodbye!\n\n" RESET);
@@ -332,29 +256,35 @@ int main()
             printf(RED "Oops! Please enter a valid choice.\n\n" RESET);
             break;
         }
-    } while (choice != 0);
 
-    // Free allocated memory
-    free_flights_list(flights);
-    free_passengers_list(passengers);
+        // Fold the journal into a new save once it grows too large
+        if ((status = fdb_maintain(database)) != FDB_OK)
+        {
+            print_status(status);
+        }
+    }
+
+    // Close the journal and free allocated memory
+    fdb_close(database);
 
     return 0;
 }
 
-int main_menu()
+int main_menu(FlightDB *db)
 {
     // Variables
     int choice;
+    DateTime now;
 
     // Set the current date when the main menu starts
-    update_current_datetime();
+    fdb_update_time(db);
+    now = fdb_now(db);
 
-    // Print the current_datetime
+    // Print the current date and time
     printf(B_CYAN "============== Date and Time ==============\n" RESET);
     printf(" %d %s %d %02d:%02d\n",
-           current_datetime.date.day, current_datetime.date.month, current_datetime.date.year,
-           current_datetime.time.hours, current_datetime.time.minutes);
-
+           now.date.day, int_to_month(now.date.month), now.date.year,
+           now.time.hours, now.time.minutes);
     // Print the main menu
     printf(B_CYAN "================== Menu ===================\n" RESET);
     printf(" 1 | Add Flight\n");
@@ -396,425 +326,39 @@ bool confirm_delete(char *prompt)
     }
 }
 
+
 void clean_exit()
 {
-    // Free allocated memory from linked lists
-    free_flights_list(flights);
-    free_passengers_list(passengers);
+    // Close the journal (every finished change is already synced to it) and free allocated memory
+    fdb_close(database);
 
     // Exit with a failure status
     exit(EXIT_FAILURE);
 }
 
-void update_current_datetime()
+void out_of_memory()
 {
-    // Initialize a time_t variable with the current time and set the struct tm pointer to the local time
-    time_t now = time(NULL);
-    struct tm *time_now = localtime(&now);
-
-    // Initialize a Date from the struct tm's year, month, and day
-    Date c_date = {
-        .year = (time_now->tm_year + 1900), // tm_year => years since 1900
-        .day = time_now->tm_mday,
-    };
-    strncpy(c_date.month, MONTHS[time_now->tm_mon], MONTH_STR_SIZE);
-
-    // Initialize a Time from the struct tm's hours and minutes
-    Time c_time = {
-        .hours = time_now->tm_hour,
-        .minutes = time_now->tm_min,
-    };
-
-    // Set the current_datetime to the current date and time
-    current_datetime = (DateTime){
-        .date = c_date,
-        .time = c_time,
-    };
+    // Called by the database when an allocation fails
+    printf(RED "Oops! Memory allocation failed.\n\n" RESET);
+    clean_exit();
 }
 
-char *toupper_string(char *string)
+void print_status(int status)
 {
-    if (string != NULL)
-    {
-        for (int i = 0; string[i] != '\0'; i++)
-        {
-            if (islower(string[i]))
-            {
-                string[i] = toupper(string[i]); // Convert lowercase letters to uppercase
-            }
-        }
-    }
-    return string;
-}
-
-char *capitalize_string(char *string)
-{
-    if (string != NULL)
-    {
-        for (int i = 0; string[i] != '\0'; i++)
-        {
-            switch (i)
-            {
-            case 0: // Convert the first character to uppercase
-                string[i] = toupper(string[i]);
-                break;
-            default: // Convert all other characters to lowercase
-                if (string[i - 1] != ' ')
-                {
-                    string[i] = tolower(string[i]);
-                }
-                else
-                {
-                    string[i] = toupper(string[i]);
-                }
-                break;
-            }
-        }
-    }
-    return string;
-}
-
-FlightStatus retrieve_flight_status(Flight *flight)
-{
-    // Variable
-    FlightStatus status;
-
-    // Update the current_datetime
-    update_current_datetime();
-
-    // Check if the current datetime is NOT in the future of the flight's departure (current_datetime <= departure)
-    status.flight_departed = !is_future(current_datetime, flight->departure);
-
-    // Check if the current_datetime is in the future of the flight's arrival (arrival < current_datetime)
-    status.flight_arrived = is_future(flight->arrival, current_datetime);
-
-    return status;
-}
-
-int flight_compare(Flight *a, Flight *b)
-{
-    // Convert DateTime to minutes
-    long long a_departure_in_minutes = datetime_to_minutes(a->departure);
-    long long b_departure_in_minutes = datetime_to_minutes(b->departure);
-
-    // Sort by Departure
-    if (a_departure_in_minutes - b_departure_in_minutes != 0)
-    {
-        return a_departure_in_minutes - b_departure_in_minutes; // Return an integer indicating the order
-    }
-
-    // Sort by Origin
-    int origin_cmp = strcmp(a->origin, b->origin);
-    if (origin_cmp != 0)
-    {
-        return origin_cmp; // Return the result of strcmp()
-    }
-
-    // Sort by Destination
-    int destination_cmp = strcmp(a->destination, b->destination);
-    if (destination_cmp != 0)
-    {
-        return destination_cmp; // Return the result of strcmp()
-    }
-
-    // If all else fails, the flights are equal
-    return 0;
-}
-
-int passenger_compare(Passenger *a, Passenger *b)
-{
-    // Sort by First Names
-    int first_name_cmp = strcmp(a->first_name, b->first_name);
-    if (first_name_cmp != 0)
-    {
-        return first_name_cmp; // Return the result of strcmp()
-    }
-
-    // Sort by Last Names
-    int last_name_cmp = strcmp(a->last_name, b->last_name);
-    if (last_name_cmp != 0)
-    {
-        return last_name_cmp; // Return the result of strcmp()
-    }
-
-    // If all else fails, the passengers are equal
-    return 0;
-}
-
-bool is_valid_day(int day, char *month, int year)
-{
-    // Check if the month is February
-    if (strcmp(month, "February") == 0)
-    {
-        // If the year is a leap year
-        if (is_leap(year))
-        {
-            return day >= 1 && day <= 29; // Check if the day is in the range [1,29]
-        }
-        else
-        {
-            return day >= 1 && day <= 28; // Check if the day is in the range [1,28]
-        }
-    }
-    // Check if the month is April, June, September, or November
-    else if (strcmp(month, "April") == 0 || strcmp(month, "June") == 0 ||
-             strcmp(month, "September") == 0 || strcmp(month, "November") == 0)
-    {
-        return day >= 1 && day <= 30; // Check if the day is in the range [1,30]
-    }
-    // Check if the month is a 31-day month
-    else
-    {
-        return day >= 1 && day <= 31; // Check if the day is in the range [1,31]
-    }
-}
-
-bool is_valid_month(char *input)
-{
-    for (int i = 0; i < 12; i++)
-    {
-        if (strcmp(input, MONTHS[i]) == 0)
-        {
-            return true; // Return true if input is in the MONTHS array
-        }
-    }
-    return false; // Return false otherwise
-}
-
-bool is_valid_nonempty_string(char *string)
-{
-    if (strlen(string) == 0)
-    {
-        return false; // Return false if the string is empty
-    }
-    return true; // Return true otherwise
-}
-
-bool is_valid_id(char *id)
-{
-    if (strlen(id) == 0)
-    {
-        return false; // Return false if the id is length 0 (no id)
-    }
-    if (strlen(id) > FLIGHT_ID_STR_LEN)
-    {
-        return false; // Return false if the id length exceeds the maximum length FLIGHT_ID_STR_LEN
-    }
-    for (int i = 0; id[i] != '\0'; i++)
-    {
-        if (!isalnum(id[i]))
-        {
-            return false; // Return false if the id contains non-alphanumeric characters
-        }
-    }
-    return true; // Return true otherwise
-}
-
-bool is_valid_passport(char *passport_number)
-{
-    if (strlen(passport_number) != PASSPORT_NUM_STR_LEN)
-    {
-        return false; // Return false if the passport number length is not equal to PASSPORT_NUM_STR_LEN
-    }
-    for (int i = 0; passport_number[i] != '\0'; i++)
-    {
-        if (!isalnum(passport_number[i]))
-        {
-            return false; // Return false if the passport number contains non-alphanumeric characters
-        }
-    }
-    return true; // Return true otherwise
-}
-
-int month_to_int(char *month)
-{
-    for (int i = 0; i < 12; i++)
-    {
-        // Check if the input matches any month in the array
-        if (strcmp(month, MONTHS[i]) == 0)
-        {
-            return i + 1; // Returns the month number of a month string
-        }
-    }
-    return -1; // Return -1 if the month is not found
-}
-
-long long datetime_to_minutes(DateTime dt)
-{
-    // Convert each DateTime component to minutes, get the sum, then return the result
-    return dt.date.year * 525600 +
-           month_to_int(dt.date.month) * 43800 +
-           dt.date.day * 1440 +
-           dt.time.hours * 60 +
-           dt.time.minutes;
-}
-
-int days_in_month(char *month, int year)
-{
-    // Check if the month is February
-    if (strcmp(month, "February") == 0)
-    {
-        // If the year is a leap year
-        if (is_leap(year))
-        {
-            return 29; // Return 29 days if the year is a leap year and the month is February
-        }
-        else
-        {
-            return 28; // Return 28 days if the year is not a leap year and the month is February
-        }
-    }
-    // Check if the month is April, June, September, or November
-    else if (strcmp(month, "April") == 0 || strcmp(month, "June") == 0 ||
-             strcmp(month, "September") == 0 || strcmp(month, "November") == 0)
-    {
-        return 30; // Return 30 days if the month is April, June, September, or November
-    }
-    else
-    {
-        return 31; // Return 31 days if the month for all other months
-    }
-}
-
-DateTime compute_arrival_datetime(DateTime departure, Time duration)
-{
-    // Initialize arrival DateTime
-    DateTime arrival = departure;
-    arrival.time.hours += duration.hours;     // Add the duration to the hours
-    arrival.time.minutes += duration.minutes; // Add the duration to the minutes
-
-    // Normalize the minutes
-    while (arrival.time.minutes >= 60) // If the minutes exceed 59
-    {
-        arrival.time.minutes -= 60; // Subtract 60 minutes
-        arrival.time.hours++;       // Add an hour
-    }
-    // Normalize the hours
-    while (arrival.time.hours >= 24) // If the hours exceed 23
-
-    {
-        arrival.time.hours -= 24; // Subtract 24 hours
-        arrival.date.day++;       // Add a day
-    }
-    // Normalize the days
-    while (arrival.date.day > days_in_month(arrival.date.month, arrival.date.year)) // If the day exceeds the number of days in the month
-    {
-        arrival.date.day -= days_in_month(arrival.date.month, arrival.date.year); // Subtract the number of days in the month of the current month
-        if (month_to_int(arrival.date.month) == 12)                               // If the month is currently December
-        {
-            arrival.date.year++; // Increment the year
-        }
-        strncpy(arrival.date.month, MONTHS[month_to_int(arrival.date.month) % 12], MONTH_STR_SIZE); // Increment the month
-    }
-
-    return arrival; // Return the arrival DateTime
-}
-
-bool is_conflicting(DateTime departure1, DateTime arrival1, DateTime departure2, DateTime arrival2)
-{
-    // Convert DateTime to minutes
-    long long departure1_in_minutes = datetime_to_minutes(departure1);
-    long long arrival1_in_minutes = datetime_to_minutes(arrival1);
-    long long departure2_in_minutes = datetime_to_minutes(departure2);
-    long long arrival2_in_minutes = datetime_to_minutes(arrival2);
-
-    // Check if the DateTime is in the bounds of another DateTime
-    if ((departure1_in_minutes <= arrival2_in_minutes) && (arrival1_in_minutes >= departure2_in_minutes))
-    {
-        return true; // Return true if the DateTime is in the bounds of another DateTime
-    }
-    else
-    {
-        return false; // Return false otherwise
-    }
-}
-
-bool is_leap(int year)
-{
-    if (year % 4 != 0) // A leap year must be divisible by 4...
-    {
-        return false;
-    }
-    if (year % 100 != 0) // ...but must not be divisible by 100...
-    {
-        return true;
-    }
-    if (year % 400 == 0) // ...unless it is divisible by 400
-    {
-        return true;
-    }
-    return false;
-}
-
-bool is_future(DateTime date1, DateTime date2)
-{
-    // Check if the date2 DateTime is in the future compared to the date1 DateTime
-    return datetime_to_minutes(date2) > datetime_to_minutes(date1);
-}
-
-bool is_valid_birthdate(Date birth_date)
-{
-    // Check if the age of the person is less than or equal to MAX_AGE
-    return current_datetime.date.year - birth_date.year <= MAX_AGE;
+    // Print the message of the status code
+    printf(RED "Oops! %s\n\n" RESET, fdb_status_message(status));
 }
 
 char *get_string(char *prompt, FILE *stream)
 {
-    // Variables
-    int buffer_length = INITIAL_BUFFER_SIZE, c, i = 0;
-    char *temp;
-
     // Print prompt if there is a prompt
     if (prompt != NULL)
     {
         printf("%s", prompt);
     }
 
-    // Allocate memory for a string
-    char *buffer = (char *)malloc(sizeof(char) * buffer_length);
-    if (buffer == NULL) // If malloc failed
-    {
-        printf(RED "Oops! Memory allocation failed.\n\n" RESET);
-        clean_exit();
-    }
-
-    while ((c = fgetc(stream)) != '\n' && c != EOF) // Read characters from the file stream one by one
-    {
-        // Fill the buffer with the characters from the file stream
-        buffer[i++] = c;
-
-        // If we've reached the end of the buffer, reallocate more memory
-        if (i == buffer_length)
-        {
-            buffer_length *= 2;                                           // Increase size of buffer
-            temp = (char *)realloc(buffer, sizeof(char) * buffer_length); // Reallocate memory
-            if (temp == NULL)                                             // If realloc failed.
-            {
-                printf(RED "Oops! Memory allocation failed.\n\n" RESET);
-                free(buffer);
-                clean_exit();
-            }
-            else
-            {
-                buffer = temp; // Point the buffer to the new memory (if it ever moved)
-            }
-        }
-    }
-
-    // Null-terminate the string
-    buffer[i] = '\0';
-
-    // Shrink the buffer to the actual size
-    temp = (char *)realloc(buffer, sizeof(char) * (i + 1));
-    if (temp == NULL) // If realloc fails
-    {
-        printf(RED "Oops! Memory allocation failed.\n\n" RESET);
-        free(buffer);
-        clean_exit();
-    }
-    buffer = temp; // The buffer is resized to the optimal size
-
-    return buffer; // Return the string
+    // Read the line (an allocation failure ends in out_of_memory())
+    return read_line(stream);
 }
 
 int get_int(char *prompt)
@@ -873,7 +417,7 @@ Date get_date(char *prompt)
         }
         else
         {
-            strncpy(new_date.month, input, MONTH_STR_SIZE);
+            new_date.month = month_to_int(input);
         }
         free(input);
     } while (!month_is_valid);
@@ -882,7 +426,7 @@ Date get_date(char *prompt)
     do
     {
         new_date.day = get_int("Day:     ");
-        day_is_valid = is_valid_day(new_date.day, new_date.month, new_date.year);
+        day_is_valid = new_date.day >= 1 && new_date.day <= DAYS_IN_MONTH[1][new_date.month]; // The year is not known yet, so allow the longest the month can be
         if (!day_is_valid)
         {
             printf(RED "Oops! Invalid day. Please type a valid day.\n" RESET);
@@ -890,7 +434,15 @@ Date get_date(char *prompt)
     } while (!day_is_valid);
 
     // Ask for a year
-    new_date.year = get_int("Year:    ");
+    do
+    {
+        new_date.year = get_int("Year:    ");
+        day_is_valid = is_valid_day(new_date.day, new_date.month, new_date.year);
+        if (!day_is_valid)
+        {
+            printf(RED "Oops! Invalid year. %d %s only exists in leap years.\n" RESET, new_date.day, int_to_month(new_date.month));
+        }
+    } while (!day_is_valid);
 
     return new_date;
 }
@@ -899,7 +451,7 @@ Time get_time(char *prompt, bool is_duration)
 {
     // Variables
     Time new_time;
-    bool is_valid_duration = false;
+    bool duration_is_valid = false;
 
     // If we are getting a duration, repeatedly ask for a duration until it is valid
     do
@@ -934,30 +486,31 @@ Time get_time(char *prompt, bool is_duration)
         if (is_duration)
         {
             // Check if the duration is valid
-            if (new_time.hours * 60 + new_time.minutes >= MIN_FLIGHT_DURATION_IN_MINUTES && new_time.hours * 60 + new_time.minutes <= MAX_FLIGHT_DURATION_IN_MINUTES)
+            if (is_valid_duration(new_time))
             {
-                is_valid_duration = true;
+                duration_is_valid = true;
             }
             else
             {
                 printf(RED "Oops! Duration is not in range (00:01 - 18:50).\n" RESET);
             }
         }
-    } while ((is_duration && !is_valid_duration));
+    } while ((is_duration && !duration_is_valid));
 
     return new_time;
 }
 
-DateTime get_departure_datetime(char *prompt)
+DateTime get_departure_datetime(FlightDB *db, char *prompt)
 {
     // Variables
     Date new_date;
     Time new_time;
-    DateTime new_datetime;
+    DateTime new_datetime, now;
     bool datetime_is_future = false;
 
     // Update the current datetime
-    update_current_datetime();
+    fdb_update_time(db);
+    now = fdb_now(db);
 
     do
     {
@@ -967,8 +520,8 @@ DateTime get_departure_datetime(char *prompt)
             printf("\n%s\n\n", prompt);
             printf("Current: ");
             printf("%d %s %d %02d:%02d\n\n",
-                   current_datetime.date.day, current_datetime.date.month, current_datetime.date.year,
-                   current_datetime.time.hours, current_datetime.time.minutes);
+                   now.date.day, int_to_month(now.date.month), now.date.year,
+                   now.time.hours, now.time.minutes);
         }
         // Ask for a Date (Year, Month, Day)
         new_date = get_date(NULL);
@@ -977,10 +530,11 @@ DateTime get_departure_datetime(char *prompt)
         new_time = get_time(B_CYAN "--- Departure Time --------------------" RESET, false);
 
         // Reupdate the current datetime
-        update_current_datetime();
+        fdb_update_time(db);
+        now = fdb_now(db);
 
         // Check if the DateTime is in the future
-        datetime_is_future = is_future(current_datetime, (DateTime){.date = new_date, .time = new_time});
+        datetime_is_future = is_future(now, (DateTime){.date = new_date, .time = new_time});
 
         if (!datetime_is_future)
         {
@@ -988,11 +542,11 @@ DateTime get_departure_datetime(char *prompt)
             printf(RED "Oops! Departure must be after current date and time.\n" RESET);
             printf(BLUE "Current:   ");
             printf("%d %s %d %02d:%02d\n" RESET,
-                   current_datetime.date.day, current_datetime.date.month, current_datetime.date.year,
-                   current_datetime.time.hours, current_datetime.time.minutes);
+                   now.date.day, int_to_month(now.date.month), now.date.year,
+                   now.time.hours, now.time.minutes);
             printf(RED "Departure: ");
             printf("%d %s %d %02d:%02d\n" RESET,
-                   new_date.day, new_date.month, new_date.year,
+                   new_date.day, int_to_month(new_date.month), new_date.year,
                    new_time.hours, new_time.minutes);
         }
     } while (!datetime_is_future);
@@ -1003,472 +557,113 @@ DateTime get_departure_datetime(char *prompt)
     return new_datetime;
 }
 
-void free_flight_node(Flight *node)
+void output_init(OutputBuffer *out)
 {
-    // Only free the node if it is NOT NULL
-    if (node != NULL)
-    {
-        // Free strings in the node
-        if (node->flight_id != NULL)
-        {
-            free(node->flight_id);
-        }
-        if (node->destination != NULL)
-        {
-            free(node->destination);
-        }
-        if (node->origin != NULL)
-        {
-            free(node->origin);
-        }
+    // Only pause when a person is reading the output (not when input or output is redirected)
+    *out = (OutputBuffer){.data = NULL, .size = 0, .capacity = OUTPUT_BUFFER_SIZE, .lines = 0,
+                          .paging = isatty(STDIN_FILENO) && isatty(STDOUT_FILENO), .stopped = false};
 
-        // Free the node
-        free(node);
-    }
-}
-
-void free_passenger_node(Passenger *node)
-{
-    // Only free the node if it is NOT NULL
-    if (node != NULL)
+    // Allocate memory for the first screen
+    out->data = (char *)malloc(out->capacity);
+    if (out->data == NULL) // If malloc failed
     {
-        // Free strings in the node
-        if (node->first_name != NULL)
-        {
-            free(node->first_name);
-        }
-        if (node->last_name != NULL)
-        {
-            free(node->last_name);
-        }
-        if (node->passport_number != NULL)
-        {
-            free(node->passport_number);
-        }
-
-        // Free reservations
-        free_reservations_list(node->reservations);
-
-        // Free the node
-        free(node);
+        out_of_memory();
     }
 }
 
-void free_flights_list(Flight *head)
+void output_printf(OutputBuffer *out, const char *format, ...)
 {
-    // Free every node in the linked list
-    while (head != NULL)
-    {
-        Flight *temp = head;
-        head = head->next;
-        free_flight_node(temp);
-    }
-}
+    va_list args;
 
-void free_passengers_list(Passenger *head)
-{
-    // Free every node in the linked list
-    while (head != NULL)
-    {
-        Passenger *temp = head;
-        head = head->next;
-        free_passenger_node(temp);
-    }
-}
+    // Format into the free space first
+    va_start(args, format);
+    va_list retry;
+    va_copy(retry, args);
+    int length = vsnprintf(out->data + out->size, out->capacity - out->size, format, args);
+    va_end(args);
 
-void free_reservations_list(Reservation *head)
-{
-    // Free every node in the linked list
-    while (head != NULL)
+    // If it did not fit, write what is already formatted (and only grow the buffer for a very long string)
+    if (length >= 0 && out->size + length + 1 > out->capacity)
     {
-        Reservation *temp = head;
-        head = head->next;
-        free(temp);
-    }
-}
-
-Flight *create_flight_node()
-{
-    // Allocate memory for a new Flight node
-    Flight *new_flight = (Flight *)malloc(sizeof(Flight));
-    if (new_flight == NULL) // If malloc failed
-    {
-        printf(RED "Oops! Memory allocation failed.\n" RESET);
-        clean_exit();
-    }
-
-    // Set fields to defaults
-    *new_flight = (Flight){
-        .flight_id = NULL,
-        .destination = NULL,
-        .origin = NULL,
-        .departure.date = (Date){.day = 0, .month = "", .year = 0},
-        .arrival.date = (Date){.day = 0, .month = "", .year = 0},
-        .departure.time = (Time){.hours = 0, .minutes = 0},
-        .arrival.time = (Time){.hours = 0, .minutes = 0},
-        .passenger_qty = 0,
-        .bonus_miles = 0,
-        .prev = NULL,
-        .next = NULL};
-
-    return new_flight;
-}
-
-Flight *search_flight_node(Flight *head, char *flight_id)
-{
-    // Start from the head
-    Flight *curr = head;
-
-    // Traverse the linked list
-    while (curr != NULL)
-    {
-        if (strcmp(curr->flight_id, flight_id) == 0)
+        output_flush(out);
+        if ((size_t)length + 1 > out->capacity)
         {
-            return curr; // Return the pointer to the node if found
-        }
-        curr = curr->next;
-    }
-    return NULL; // Return NULL if not found
-}
-
-void insert_flight_node(Flight **head, Flight *node)
-{
-    // Start from the head
-    Flight *curr = *head;
-
-    // If the list is empty OR the new node is before the head in order
-    if (*head == NULL || flight_compare(node, *head) < 0)
-    {
-        node->next = *head;
-        if (*head != NULL)
-        {
-            (*head)->prev = node;
-        }
-        *head = node;
-    }
-    // Traverse the list until we find the correct position
-    else
-    {
-        while (curr->next != NULL && flight_compare(node, curr->next) >= 0)
-        {
-            curr = curr->next;
-        }
-        node->next = curr->next;
-        if (curr->next != NULL)
-        {
-            curr->next->prev = node;
-        }
-        curr->next = node;
-        node->prev = curr;
-    }
-}
-
-void reinsert_flight_node(Flight **head, Flight *node)
-{
-    // If the node to delete is the head
-    if (*head == node)
-    {
-        *head = (*head)->next;
-        if (*head != NULL)
-        {
-            (*head)->prev = NULL;
-        }
-    }
-    else
-    {
-        if (node->next != NULL)
-        {
-            node->next->prev = node->prev;
-        }
-        if (node->prev != NULL)
-        {
-            node->prev->next = node->next;
+            char *temp = (char *)realloc(out->data, length + 1);
+            if (temp == NULL) // If realloc failed
+            {
+                va_end(retry);
+                out_of_memory();
+            }
+            out->data = temp;
+            out->capacity = length + 1;
         }
+        vsnprintf(out->data, out->capacity, format, retry);
     }
+    va_end(retry);
 
-    // Reset the node's pointers
-    node->prev = NULL;
-    node->next = NULL;
-
-    // Reinsert the node
-    insert_flight_node(&(*head), node);
-}
-
-void delete_flight_node(Flight **head, char *flight_id)
-{
-    // Start from the head
-    Flight *curr = *head;
-
-    // If the node to delete is the head
-    if (strcmp((*head)->flight_id, flight_id) == 0)
-    {
-        *head = (*head)->next;
-
-        free_flight_node(curr);
-        return;
-    }
-
-    // Find the node to delete
-    while (curr != NULL && strcmp(curr->flight_id, flight_id) != 0)
+    if (length < 0)
     {
-        curr = curr->next;
-    }
-
-    // If the node was not found
-    if (curr == NULL)
-    {
-        printf(RED "Oops! That Flight does not exist.\n\n" RESET);
         return;
     }
 
-    // Remove the node from the list
-    if (curr->next != NULL)
+    // Count the lines for paging
+    for (int i = 0; out->paging && i < length; i++)
     {
-        curr->next->prev = curr->prev;
-    }
-    if (curr->prev != NULL)
-    {
-        curr->prev->next = curr->next;
-    }
-    free_flight_node(curr); // Free the deleted node
-}
-
-int count_flights(Flight *head)
-{
-    int count = 0;
-
-    // Start from the head
-    Flight *ptr = head;
-
-    // Traverse the linked list, incrementing per node
-    while (ptr != NULL)
-    {
-        count++;
-        ptr = ptr->next;
-    }
-
-    return count; // Return the count
-}
-
-Passenger *create_passenger_node()
-{
-    // Allocate memory for a Passenger node
-    Passenger *new_passenger = (Passenger *)malloc(sizeof(Passenger));
-    if (new_passenger == NULL) // If malloc failed
-    {
-        printf(RED "Oops! Memory allocation failed.\n\n" RESET);
-        clean_exit();
-    }
-
-    // Initialize fields to defaults
-    *new_passenger = (Passenger){
-        .first_name = NULL,
-        .last_name = NULL,
-        .birth_date = (Date){.day = 0, .month = "", .year = 0},
-        .passport_number = NULL,
-        .reservation_qty = 0,
-        .miles = 0,
-        .prev = NULL,
-        .next = NULL};
-
-    return new_passenger; // Return the Passenger
-}
-
-Passenger *search_passenger_node(Passenger *head, char *passport_number)
-{
-    // Start from the head
-    Passenger *curr = head;
-
-    // Traverse the linked list
-    while (curr != NULL)
-    {
-        if (strcmp(curr->passport_number, passport_number) == 0)
+        if (out->data[out->size + i] == '\n')
         {
-            return curr; // Return the pointer to the node
+            out->lines++;
         }
-        curr = curr->next;
-    }
-
-    return NULL; // Return NULL if node does not exist
-}
-
-void insert_passenger_node(Passenger **head, Passenger *node)
-{
-    // Start from the head
-    Passenger *curr = *head;
-
-    // If the list is empty OR the new node is before the head in order
-    if (*head == NULL || passenger_compare(node, *head) < 0)
-    {
-        node->next = *head;
-        if (node->next != NULL)
-        {
-            node->next->prev = node;
-        }
-        *head = node;
-    }
-    // Traverse the list until we find the correct position
-    else
-    {
-        while (curr->next != NULL && passenger_compare(node, curr->next) >= 0)
-        {
-            curr = curr->next;
-        }
-        node->next = curr->next;
-        if (node->next != NULL)
-        {
-            node->next->prev = node;
-        }
-        curr->next = node;
-        node->prev = curr;
-    }
-}
-
-int count_passengers(Passenger *head)
-{
-    int count = 0;
-
-    // Start from the head
-    Passenger *ptr = head;
-
-    // Traverse the linked list, incrementing per node
-    while (ptr != NULL)
-    {
-        count++;
-        ptr = ptr->next;
     }
-
-    return count; // Return the count
+    out->size += length;
 }
 
-Reservation *create_reservation_node(Flight *flight)
+void output_page(OutputBuffer *out)
 {
-    // Allocate memory for a Reservation node
-    Reservation *new_reservation = (Reservation *)malloc(sizeof(Reservation));
-    if (new_reservation == NULL) // If malloc failed
+    // Nothing to do until a full page is formatted
+    if (!out->paging || out->lines < LISTING_PAGE_LINES)
     {
-        printf(RED "Oops! Memory allocation failed.\n\n" RESET);
-        clean_exit();
-    }
-
-    // Initialize field with the Flight
-    *new_reservation = (Reservation){
-        .flight = flight, .prev = NULL, .next = NULL};
-
-    return new_reservation; // Return the Reservation
-}
-
-Reservation *search_reservation_node(Reservation *head, Flight *flight)
-{
-    // Start from the head
-    Reservation *curr = head;
-
-    // Traverse the linked list
-    while (curr != NULL)
-    {
-        if (strcmp(curr->flight->flight_id, flight->flight_id) == 0)
-        {
-            return curr; // Return the pointer to the node
-        }
-        curr = curr->next;
+        return;
     }
-    return NULL; // Return NULL if node does not exist
-}
-
-void insert_reservation_node(Reservation **head, Reservation *node)
-{
-    // Start from the head
-    Reservation *curr = *head;
 
-    // If the list is empty OR the new node is before the *head in order
-    if (*head == NULL || flight_compare(node->flight, (*head)->flight) < 0)
-    {
-        node->next = *head;
-        if (node->next != NULL)
-        {
-            node->next->prev = node;
-        }
-        *head = node;
-    }
-    // Traverse the list until we find the correct position
-    else
+    // Show the page and let the user continue or stop
+    output_flush(out);
+    char *input = get_string(B_CYAN "-- More -- (Enter to continue, Q to stop) " RESET, stdin);
+    if (toupper(input[0]) == 'Q')
     {
-        while (curr->next != NULL && flight_compare(node->flight, (*head)->flight) >= 0)
-        {
-            curr = curr->next;
-        }
-        node->next = curr->next;
-        if (node->next != NULL)
-        {
-            node->next->prev = node;
-        }
-        curr->next = node;
-        node->prev = curr;
+        out->stopped = true;
     }
+    free(input);
+    out->lines = 0;
 }
 
-void delete_reservation_node(Reservation **head, Flight *flight)
+void output_flush(OutputBuffer *out)
 {
-    // Start from the head
-    Reservation *curr = *head;
-
-    if ((*head)->flight == flight) // If the node to delete is the head
+    // Write the whole buffer at once
+    if (out->size > 0)
     {
-        *head = (*head)->next;
-        if (*head != NULL)
-        {
-            (*head)->prev = NULL;
-        }
-        free(curr);
-        return;
-    }
-
-    // Find the node to delete
-    while (curr->flight != flight) // Find the node to delete
-    {
-        curr = curr->next;
+        fwrite(out->data, 1, out->size, stdout);
+        fflush(stdout);
     }
-
-    // If the node was not found
-    if (curr == NULL)
-    {
-        printf(RED "Oops! Reservation does not exist.\n\n" RESET);
-        return;
-    }
-    // Remove the node from the linked list
-    if (curr->next != NULL)
-    {
-        curr->next->prev = curr->prev;
-    }
-    if (curr->prev != NULL)
-    {
-        curr->prev->next = curr->next;
-    }
-    free(curr); // Free the deleted node
+    out->size = 0;
 }
 
-int count_reservations(Reservation *head)
+void free_output_buffer(OutputBuffer *out)
 {
-    int count = 0;
-
-    // Start from the head
-    Reservation *ptr = head;
-
-    // Traverse the list, incrementing per node
-    while (ptr != NULL)
-    {
-        count++;
-        ptr = ptr->next;
-    }
-
-    return count; // Return the count
+    free(out->data);
+    out->data = NULL;
+    out->size = 0;
+    out->capacity = 0;
 }
 
-void add_flight(Flight **head)
+void add_flight(FlightDB *db)
 {
     // Variables
     char *flight_id = NULL;
+    char *origin = NULL;
+    char *destination = NULL;
+    DateTime departure;
     Time duration;
+    int passenger_max, bonus_miles, status;
     bool string_is_valid = false, dest_is_origin = true;
 
     printf(B_CYAN "== Add Flight =============================\n\n" RESET);
@@ -1477,32 +672,28 @@ void add_flight(Flight **head)
     flight_id = toupper_string(get_string("Flight ID:   ", stdin));
     if (!is_valid_id(flight_id))
     {
-        printf(RED "Oops! A valid Flight ID has at least 1 and at most 6 uppercase letters and/or digits only.\n\n" RESET);
+        print_status(FDB_INVALID_FLIGHT_ID);
         free(flight_id);
         return;
     }
-    if (search_flight_node(*head, flight_id) != NULL)
+    if (fdb_find_flight(db, flight_id) != NULL)
     {
-        printf(RED "Oops! That Flight already exists.\n\n" RESET);
+        print_status(FDB_FLIGHT_EXISTS);
         free(flight_id);
         return;
     }
 
-    // Create the Flight node and set its flight_id
-    Flight *new_flight = create_flight_node();
-    new_flight->flight_id = flight_id;
-
     // Ask for Origin
     do
     {
         // Free previous input from the previous loop
-        if (new_flight->origin != NULL)
+        if (origin != NULL)
         {
-            free(new_flight->origin);
+            free(origin);
         }
 
-        new_flight->origin = capitalize_string(get_string("Origin:      ", stdin));
-        string_is_valid = is_valid_nonempty_string(new_flight->origin);
+        origin = capitalize_string(get_string("Origin:      ", stdin));
+        string_is_valid = is_valid_nonempty_string(origin);
 
         if (!string_is_valid)
         {
@@ -1514,138 +705,144 @@ void add_flight(Flight **head)
     do
     {
         // Free previous input from the previous loop
-        if (new_flight->destination != NULL)
+        if (destination != NULL)
         {
-            free(new_flight->destination);
+            free(destination);
         }
 
-        new_flight->destination = capitalize_string(get_string("Destination: ", stdin));
-        string_is_valid = is_valid_nonempty_string(new_flight->destination);
+        destination = capitalize_string(get_string("Destination: ", stdin));
+        string_is_valid = is_valid_nonempty_string(destination);
         if (!string_is_valid)
         {
             printf(RED "Oops! Destination cannot be empty.\n" RESET);
         }
-        if ((dest_is_origin = strcmp(new_flight->destination, new_flight->origin) == 0))
+        if ((dest_is_origin = strcmp(destination, origin) == 0))
         {
             printf(RED "Oops! Destination cannot be the same as the origin.\n" RESET);
         }
     } while (!string_is_valid || dest_is_origin);
 
     // Ask for Departure DateTime
-    new_flight->departure = get_departure_datetime(B_CYAN "--- Departure Date --------------------" RESET);
+    departure = get_departure_datetime(db, B_CYAN "--- Departure Date --------------------" RESET);
 
     // Ask for Duration
     duration = get_time(B_CYAN "--- Duration --------------------------" RESET, "duration");
 
-    // Compute for the Arrival DateTime
-    new_flight->arrival = compute_arrival_datetime(new_flight->departure, duration);
-
-    // Number of Booked Passengers is already set to 0
-
     // Ask for Max Count of Passengers (Seats)
     printf(B_CYAN "\n---------------------------------------\n\n" RESET);
     do
     {
-        new_flight->passenger_max = get_int("Max Seats:   ");
-        if (new_flight->passenger_max < MIN_PASSENGERS_PER_FLIGHT)
+        passenger_max = get_int("Max Seats:   ");
+        if (passenger_max < MIN_PASSENGERS_PER_FLIGHT)
         {
             printf(RED "Oops! The maximum number of passengers must be at least %d.\n" RESET, MIN_PASSENGERS_PER_FLIGHT);
         }
-    } while (new_flight->passenger_max < MIN_PASSENGERS_PER_FLIGHT);
+    } while (passenger_max < MIN_PASSENGERS_PER_FLIGHT);
 
     // Ask for Bonus Miles
     do
     {
-        new_flight->bonus_miles = get_int("Bonus Miles: ");
-        if (new_flight->bonus_miles < 0)
+        bonus_miles = get_int("Bonus Miles: ");
+        if (bonus_miles < 0)
         {
             printf(RED "Oops! The bonus miles must be at least 0.\n" RESET);
         }
-    } while (new_flight->bonus_miles < 0);
-
-    // Insert the Flight to the linked list
-    insert_flight_node(&(*head), new_flight);
+    } while (bonus_miles < 0);
 
-    // Print a success message
-    printf(GREEN "\nSuccess: Added Flight %s.\n\n" RESET, new_flight->flight_id);
+    // Add the Flight to the database (the departure is checked again, since time passed while asking)
+    status = fdb_add_flight(db, flight_id, origin, destination, departure, duration, passenger_max, bonus_miles);
+    if (status == FDB_OK)
+    {
+        // Print a success message
+        printf(GREEN "\nSuccess: Added Flight %s.\n\n" RESET, flight_id);
+    }
+    else
+    {
+        printf("\n");
+        print_status(status);
+    }
+    free(flight_id);
+    free(origin);
+    free(destination);
 }
 
-void edit_flight(Flight **head)
+void edit_flight(FlightDB *db)
 {
     // Variables
     char *flight_id;
     Flight *f_ptr = NULL;
+    DateTime departure;
     Time duration;
-    FlightStatus status;
+    FlightStatus flight_status;
+    int passenger_max, status;
 
     printf(B_CYAN "== Edit Flight ============================\n\n" RESET);
 
     // If there are no flights to edit
-    if (*head == NULL)
+    if (fdb_flights(db) == NULL)
     {
         printf(BLUE "Info: There are currently no flights.\n\n" RESET);
         return;
     }
 
     // Print flights (in linear form)
-    view_flights_linear(*head, VIEW_FLIGHTS_LINEAR_ALL);
+    view_flights_linear(db, VIEW_FLIGHTS_LINEAR_ALL);
 
     // Ask for a Flight ID and validate
     flight_id = toupper_string(get_string("Flight ID: ", stdin));
     if (!is_valid_id(flight_id))
     {
-        printf(RED "\nOops! A valid Flight ID has at least 1 and at most 6 uppercase letters and/or digits only.\n\n" RESET);
+        printf(RED "\nOops! %s\n\n" RESET, fdb_status_message(FDB_INVALID_FLIGHT_ID));
         free(flight_id);
         return;
     }
-    if ((f_ptr = search_flight_node(*head, flight_id)) == NULL)
+    if ((f_ptr = fdb_find_flight(db, flight_id)) == NULL)
     {
-        printf(RED "\nOops! That Flight does not exist.\n\n" RESET);
+        printf(RED "\nOops! %s\n\n" RESET, fdb_status_message(FDB_FLIGHT_NOT_FOUND));
         free(flight_id);
         return;
     }
     free(flight_id);
 
-    status = retrieve_flight_status(f_ptr);
-    if (status.flight_departed && !status.flight_arrived)
+    flight_status = fdb_flight_status(db, f_ptr);
+    if (flight_status.flight_departed)
     {
-        printf(RED "\nOops! That Flight is currently ongoing.\n\n" RESET);
-        return;
-    }
-    else if (status.flight_departed && status.flight_arrived)
-    {
-        printf(RED "\nOops! That Flight has already arrived.\n\n" RESET);
+        printf(RED "\nOops! %s\n\n" RESET, fdb_status_message(flight_status.flight_arrived ? FDB_FLIGHT_ARRIVED : FDB_FLIGHT_ONGOING));
         return;
     }
 
     printf(B_CYAN "\n--- Flight Details --------------------\n\n" RESET);
-    print_flight(f_ptr);
+    print_flight(db, f_ptr);
 
     // New Departure DateTime
-    f_ptr->departure = get_departure_datetime(B_CYAN "--- Departure Date --------------------" RESET);
+    departure = get_departure_datetime(db, B_CYAN "--- Departure Date --------------------" RESET);
 
     // New Duration (for a new Arrival DateTime)
     duration = get_time(B_CYAN "--- Duration --------------------------" RESET, "duration");
 
-    // Compute for the new Arrival DateTime
-    f_ptr->arrival = compute_arrival_datetime(f_ptr->departure, duration);
-
     // New Max Passengers (Seats)
     printf(B_CYAN "\n---------------------------------------\n\n" RESET);
     do
     {
-        f_ptr->passenger_max = get_int("Max Seats: ");
-        if (f_ptr->passenger_max < MIN_PASSENGERS_PER_FLIGHT)
+        passenger_max = get_int("Max Seats: ");
+        if (passenger_max < MIN_PASSENGERS_PER_FLIGHT)
         {
             printf(RED "Oops! The maximum number of passengers must be at least %d.\n" RESET, MIN_PASSENGERS_PER_FLIGHT);
         }
-        else if (f_ptr->passenger_max < f_ptr->passenger_qty)
+        else if (passenger_max < f_ptr->passenger_qty)
         {
             printf(RED "Oops! You cannot decrease maximum passengers below number of reserved passengers.\n" RESET);
         }
-    } while (f_ptr->passenger_max < MIN_PASSENGERS_PER_FLIGHT || f_ptr->passenger_max < f_ptr->passenger_qty);
+    } while (passenger_max < MIN_PASSENGERS_PER_FLIGHT || passenger_max < f_ptr->passenger_qty);
 
-    reinsert_flight_node(&(*head), f_ptr);
+    // Change the Flight (which reorders it and journals it)
+    status = fdb_edit_flight(db, f_ptr->flight_id, departure, duration, passenger_max);
+    if (status != FDB_OK)
+    {
+        printf("\n");
+        print_status(status);
+        return;
+    }
 
     printf(GREEN "\nSuccess: Edited Flight %s.\n\n" RESET, f_ptr->flight_id);
 }
@@ -1659,20 +856,27 @@ int view_flights_menu()
     printf(" 2 | View All Available Flights\n");
     printf(" 3 | View All Fully-booked Flights\n");
     printf(" 4 | View All Flights\n");
+    printf(" 5 | Search Flights by Route\n");
+    printf(" 6 | Find Connecting Flights\n");
     printf(" 0 | Back\n\n");
     choice = get_int("Enter choice: ");
 
     return choice;
 }
 
-void view_flights(Flight *head, int mode)
+void view_flights(FlightDB *db, int mode)
 {
     // Variables
     int count = 0;
-    Flight *ptr = head;
-    char *flight_id;
+    int position = 0;
+    Flight *ptr = fdb_flights(db);
+    char *flight_id, *origin, *destination;
     bool flights_exist, should_print;
     FlightStatus status;
+    OutputBuffer out;
+    RouteView route = {.flights = NULL, .count = 0};
+    Date date;
+    long long day_start, day_end = 0;
 
     switch (mode)
     {
@@ -1680,7 +884,7 @@ void view_flights(Flight *head, int mode)
         printf(B_CYAN "--- View Flights > Specific -----------\n\n" RESET);
 
         // Print flights (in linear form)
-        flights_exist = view_flights_linear(head, VIEW_FLIGHTS_LINEAR_ALL);
+        flights_exist = view_flights_linear(db, VIEW_FLIGHTS_LINEAR_ALL);
         if (!flights_exist)
         {
             return;
@@ -1691,25 +895,29 @@ void view_flights(Flight *head, int mode)
         printf("\n");
         if (!is_valid_id(flight_id))
         {
-            printf(RED "Oops! A valid Flight ID has at least 1 and at most 6 uppercase letters and/or digits only.\n\n" RESET);
+            print_status(FDB_INVALID_FLIGHT_ID);
             free(flight_id);
             return;
         }
-        if ((ptr = search_flight_node(head, flight_id)) == NULL)
+        if ((ptr = fdb_find_flight(db, flight_id)) == NULL)
         {
-            printf(RED "Oops! That Flight does not exist.\n\n" RESET);
+            print_status(FDB_FLIGHT_NOT_FOUND);
             free(flight_id);
             return;
         }
         free(flight_id);
 
-        // Print the flight
-        print_flight(ptr);
+        // Print the flight and the passengers booked on it
+        print_flight(db, ptr);
         printf("\n");
+        view_manifest_linear(ptr);
 
         return;
     case 2: // Mode 2: View Available Flights
         printf(B_CYAN "--- View Flights > Available ----------\n\n" RESET);
+
+        // Only walk the bookable Flights (instead of every Flight ever added)
+        ptr = fdb_available_flight(db, 0);
         break;
     case 3: // Mode 3: View Full Flights
         printf(B_CYAN "--- View Flights > Fully-Booked -------\n\n" RESET);
@@ -1717,17 +925,39 @@ void view_flights(Flight *head, int mode)
     case 4: // Mode 4: View All Flights
         printf(B_CYAN "--- View Flights > All ----------------\n\n" RESET);
         break;
+    case 6: // Mode 6: Find Connecting Flights
+        find_itinerary(db);
+        return;
+    case 5: // Mode 5: Search Flights by Route
+        printf(B_CYAN "--- View Flights > By Route -----------\n\n" RESET);
+
+        // Ask for the route (capitalized like add_flight() stores it) and the date of departure
+        origin = capitalize_string(get_string("Origin:      ", stdin));
+        destination = capitalize_string(get_string("Destination: ", stdin));
+        date = get_date(B_CYAN "--- Departure Date --------------------" RESET);
+        printf("\n");
+
+        // The route index finds the first Flight of the day with a binary search, so only that day's Flights are visited
+        day_start = datetime_to_minutes((DateTime){.date = date, .time = {.hours = 0, .minutes = 0}});
+        day_end = day_start + 24 * 60;
+        route = fdb_search_route(db, origin, destination, day_start);
+        ptr = (route.count > 0 && route.flights[0]->departure_minutes < day_end) ? route.flights[0] : NULL;
+        free(origin);
+        free(destination);
+        break;
     default:
         printf(RED "Oops! Please enter a valid choice.\n\n" RESET);
         break;
     }
 
-    while (ptr != NULL)
+    // Format the Flights into one buffer (written a screen at a time)
+    output_init(&out);
+    while (ptr != NULL && !out.stopped)
     {
         should_print = false;
 
         // Retrieve the Flight Status
-        status = retrieve_flight_status(ptr);
+        status = fdb_flight_status(db, ptr);
 
         switch (mode)
         {
@@ -1738,45 +968,127 @@ void view_flights(Flight *head, int mode)
             should_print = ptr->passenger_qty == ptr->passenger_max;
             break;
         case 4: // Mode 4: View All Flights
+        case 5: // Mode 5: Search Flights by Route
             should_print = true;
             break;
         }
 
         if (should_print)
         {
-            print_flight(ptr);
-            printf("\n");
+            render_flight(db, &out, ptr);
+            output_printf(&out, "\n");
+            output_page(&out);
             count++;
         }
 
-        ptr = ptr->next;
+        // Go to the next Flight (the next bookable one, or the next one of the route until the day ends)
+        if (mode == 2)
+        {
+            ptr = fdb_available_flight(db, ++position);
+        }
+        else if (mode == 5)
+        {
+            ptr = (++position < route.count && route.flights[position]->departure_minutes < day_end) ? route.flights[position] : NULL;
+        }
+        else
+        {
+            ptr = ptr->next;
+        }
     }
 
     if (count == 0)
     {
-        printf(BLUE "Info: There are currently no flights that fit the criteria.\n\n" RESET);
+        output_printf(&out, BLUE "Info: There are currently no flights that fit the criteria.\n\n" RESET);
+    }
+
+    output_flush(&out);
+    free_output_buffer(&out);
+}
+
+void find_itinerary(FlightDB *db)
+{
+    // Variables
+    char *origin, *destination, *passport_number;
+    Date date;
+    Itinerary itinerary;
+    int status;
+
+    printf(B_CYAN "--- View Flights > Connections --------\n\n" RESET);
+
+    // Ask for the route (capitalized like add_flight() stores it) and the earliest date of departure
+    origin = capitalize_string(get_string("Origin:      ", stdin));
+    destination = capitalize_string(get_string("Destination: ", stdin));
+    date = get_date(B_CYAN "--- Departure Date --------------------" RESET);
+
+    // Ask for a passenger whose reservations the Flights must not conflict with (or nobody)
+    printf(B_CYAN "\n---------------------------------------\n\n" RESET);
+    passport_number = toupper_string(get_string("Passport Number (blank for anyone): ", stdin));
+    printf("\n");
+    if (passport_number[0] != '\0' && !is_valid_passport(passport_number))
+    {
+        print_status(FDB_INVALID_PASSPORT);
+        free(origin);
+        free(destination);
+        free(passport_number);
+        return;
+    }
+
+    // Find the Flights arriving the earliest, departing on the date or later (and not before now)
+    long long departure = datetime_to_minutes((DateTime){.date = date, .time = {.hours = 0, .minutes = 0}});
+    if (departure <= fdb_now_minutes(db))
+    {
+        departure = fdb_now_minutes(db) + 1;
+    }
+    status = fdb_find_itinerary(db, origin, destination, departure, (passport_number[0] != '\0') ? passport_number : NULL, &itinerary);
+    free(origin);
+    free(destination);
+    free(passport_number);
+    if (status != FDB_OK)
+    {
+        print_status(status);
+        return;
+    }
+
+    // Print every Flight, with the time to connect between them
+    for (int i = 0; i < itinerary.leg_count; i++)
+    {
+        if (i > 0)
+        {
+            long long layover = itinerary.legs[i]->departure_minutes - itinerary.legs[i - 1]->arrival_minutes;
+            printf(BLUE "Info: %lld h %02lld min to connect in %s.\n\n" RESET, layover / 60, layover % 60, itinerary.legs[i]->origin);
+        }
+        print_flight(db, itinerary.legs[i]);
+        printf("\n");
     }
+
+    // Print when the trip ends
+    Flight *last = itinerary.legs[itinerary.leg_count - 1];
+    long long travel = last->arrival_minutes - itinerary.legs[0]->departure_minutes;
+    printf(GREEN "Success: Arrives in %s on %d %s %d - %02d:%02d after %d flight(s) and %lld h %02lld min.\n\n" RESET,
+           last->destination, last->arrival.date.day, int_to_month(last->arrival.date.month), last->arrival.date.year,
+           last->arrival.time.hours, last->arrival.time.minutes, itinerary.leg_count, travel / 60, travel % 60);
 }
 
-void delete_flight(Flight **f_head, Passenger *p_head)
+void delete_flight(FlightDB *db)
 {
     // Variables
     Flight *f_ptr;
-    Passenger *p_ptr;
+    char deleted_flight_id[FLIGHT_ID_STR_LEN + 1];
     bool removable_flights_exist;
-    FlightStatus status;
+    FlightStatus flight_status;
+    int status;
 
     printf(B_CYAN "== Delete Flight ==========================\n\n" RESET);
 
     // If there are no flights to delete
-    if (*f_head == NULL)
+    if (fdb_flights(db) == NULL)
     {
         printf(BLUE "Info: There are currently no flights.\n\n" RESET);
         return;
     }
 
     // Print flights (in linear form)
-    removable_flights_exist = view_flights_linear(*f_head, VIEW_FLIGHTS_LINEAR_REMOVABLE);
+    removable_flights_exist = view_flights_linear(db, VIEW_FLIGHTS_LINEAR_REMOVABLE);
     if (!removable_flights_exist)
     {
         return;
@@ -1787,48 +1099,41 @@ void delete_flight(Flight **f_head, Passenger *p_head)
     printf("\n");
     if (!is_valid_id(flight_id))
     {
-        printf(RED "Oops! A valid Flight ID has at least 1 and at most 6 uppercase letters and/or digits only.\n\n" RESET);
+        print_status(FDB_INVALID_FLIGHT_ID);
         free(flight_id);
         return;
     }
-    if ((f_ptr = search_flight_node(*f_head, flight_id)) == NULL)
+    if ((f_ptr = fdb_find_flight(db, flight_id)) == NULL)
     {
-        printf(RED "Oops! That Flight does not exist.\n\n" RESET);
+        print_status(FDB_FLIGHT_NOT_FOUND);
         free(flight_id);
         return;
     }
     free(flight_id);
 
     // Retrieve the status of the flight
-    status = retrieve_flight_status(f_ptr);
+    flight_status = fdb_flight_status(db, f_ptr);
 
-    if (!status.flight_arrived && f_ptr->passenger_qty != 0)
+    if (!flight_status.flight_arrived && f_ptr->passenger_qty != 0)
     {
-        printf(RED "Oops! Passengers have already booked this Flight.\n\n" RESET);
+        print_status(FDB_FLIGHT_BOOKED);
         return;
     }
 
     // Confirm deletion of Flight
     if (confirm_delete("Do you want to delete this Flight? (y/n): "))
     {
-        if (status.flight_arrived)
+        // Keep the Flight ID for the success message (the node is freed)
+        strcpy(deleted_flight_id, f_ptr->flight_id);
+
+        // Remove the reservations of the (arrived) Flight, delete it, and journal it
+        print_removed_reservations(f_ptr);
+        if ((status = fdb_delete_flight(db, deleted_flight_id)) != FDB_OK)
         {
-            p_ptr = p_head;
-            while (p_ptr != NULL)
-            {
-                if (search_reservation_node(p_ptr->reservations, f_ptr) != NULL)
-                {
-                    f_ptr->passenger_qty--;
-                    p_ptr->reservation_qty--;
-                    printf(BLUE "Info: Removed finished flight %s for %s.\n" RESET,
-                           f_ptr->flight_id, p_ptr->first_name);
-                    delete_reservation_node(&p_ptr->reservations, f_ptr);
-                }
-                p_ptr = p_ptr->next;
-            }
+            print_status(status);
+            return;
         }
-        printf(GREEN "Success: Deleted Flight %s.\n\n" RESET, f_ptr->flight_id);
-        delete_flight_node(&(*f_head), f_ptr->flight_id);
+        printf(GREEN "Success: Deleted Flight %s.\n\n" RESET, deleted_flight_id);
     }
     else
     {
@@ -1836,13 +1141,23 @@ void delete_flight(Flight **f_head, Passenger *p_head)
     }
 }
 
-void add_passenger(Passenger **head)
+void print_removed_reservations(Flight *flight)
+{
+    // Only an arrived Flight can still have reservations, which are removed with it (the manifest leads straight to them)
+    for (Reservation *r_ptr = flight->manifest; r_ptr != NULL; r_ptr = r_ptr->manifest_next)
+    {
+        printf(BLUE "Info: Removed finished flight %s for %s.\n" RESET, flight->flight_id, r_ptr->passenger->first_name);
+    }
+}
+
+void add_passenger(FlightDB *db)
 {
     // Variables
     char *first_name = NULL;
     char *last_name = NULL;
     Date birth_date;
     char *passport_number = NULL;
+    int miles, status;
     bool passport_is_valid, string_is_valid, birthdate_is_valid;
 
     printf(B_CYAN "== Add Passenger ==========================\n\n" RESET);
@@ -1881,11 +1196,11 @@ void add_passenger(Passenger **head)
     do
     {
         // Update the current datetime before asking for the birth date
-        update_current_datetime();
+        fdb_update_time(db);
 
         birth_date = get_date(B_CYAN "--- Date of Birth ---------------------" RESET);
         printf(B_CYAN "\n---------------------------------------\n\n" RESET);
-        birthdate_is_valid = is_valid_birthdate(birth_date);
+        birthdate_is_valid = is_valid_birthdate(birth_date, fdb_now(db));
         if (!birthdate_is_valid)
         {
             printf(RED "Oops! Please enter a valid birth date. The maximum age is %d.\n" RESET, MAX_AGE);
@@ -1905,7 +1220,7 @@ void add_passenger(Passenger **head)
         {
             printf(RED "\nOops! A valid passport number has 9 uppercase letters and/or digits.\n\n" RESET);
         }
-        if (search_passenger_node(*head, passport_number) != NULL)
+        if (fdb_find_passenger(db, passport_number) != NULL)
         {
             printf(RED "\nOops! Passenger with that passport number already exists.\n\n" RESET);
             free(first_name);
@@ -1915,48 +1230,54 @@ void add_passenger(Passenger **head)
         }
     } while (!passport_is_valid);
 
-    // Create Passenger node and initialize fields
-    Passenger *new_passenger = create_passenger_node();
-    new_passenger->first_name = first_name;
-    new_passenger->last_name = last_name;
-    new_passenger->birth_date = birth_date;
-    new_passenger->passport_number = passport_number;
-
     // Ask for Number of Miles
     do
     {
-        new_passenger->miles = get_int("Number of Miles: ");
-        if (new_passenger->miles < 0)
+        miles = get_int("Number of Miles: ");
+        if (miles < 0)
         {
             printf(RED "Oops! The number of miles must be at least 0.\n" RESET);
         }
-    } while (new_passenger->miles < 0);
-
-    // Insert the Passenger to the linked list
-    insert_passenger_node(*(&head), new_passenger);
+    } while (miles < 0);
 
-    // Print success message
-    printf(GREEN "\nSuccess: Added Passenger %s.\n\n" RESET, new_passenger->first_name);
+    // Add the Passenger to the database (and journal it)
+    status = fdb_add_passenger(db, passport_number, first_name, last_name, birth_date, miles);
+    if (status == FDB_OK)
+    {
+        // Print success message
+        printf(GREEN "\nSuccess: Added Passenger %s.\n\n" RESET, first_name);
+    }
+    else
+    {
+        printf("\n");
+        print_status(status);
+    }
+    free(first_name);
+    free(last_name);
+    free(passport_number);
 }
 
-void edit_passenger(Passenger *head)
+void edit_passenger(FlightDB *db)
 {
     // Variable
     bool string_is_valid, birthdate_is_valid;
+    Date birth_date;
+    int status;
 
     printf(B_CYAN "== Edit Passenger =========================\n\n" RESET);
 
     // If there are no passengers to edit
-    if (head == NULL)
+    if (fdb_passengers(db) == NULL)
     {
         printf(BLUE "Info: There are currently no passengers.\n\n" RESET);
         return;
     }
 
     // Print passengers (in linear form)
-    view_passengers_linear(head);
+    view_passengers_linear(fdb_passengers(db));
 
     char *passport_number;   // Input string
+    char *last_name = NULL;  // Input string
     Passenger *p_ptr = NULL; // Pointer to the Passenger to edit
 
     // Ask for a Passport Number and validate
@@ -1964,13 +1285,13 @@ void edit_passenger(Passenger *head)
     printf("\n");
     if (!is_valid_passport(passport_number))
     {
-        printf(RED "Oops! A valid Passport Number has 9 uppercase letters and/or digits.\n\n" RESET);
+        print_status(FDB_INVALID_PASSPORT);
         free(passport_number);
         return;
     }
-    if ((p_ptr = search_passenger_node(head, passport_number)) == NULL)
+    if ((p_ptr = fdb_find_passenger(db, passport_number)) == NULL)
     {
-        printf(RED "Oops! That passenger does not exist.\n\n" RESET);
+        print_status(FDB_PASSENGER_NOT_FOUND);
         free(passport_number);
         return;
     }
@@ -1983,12 +1304,12 @@ void edit_passenger(Passenger *head)
     // New Last Name
     do
     {
-        if (p_ptr->last_name != NULL)
+        if (last_name != NULL)
         {
-            free(p_ptr->last_name);
+            free(last_name);
         }
-        p_ptr->last_name = capitalize_string(get_string("Last Name: ", stdin));
-        string_is_valid = is_valid_nonempty_string(p_ptr->last_name);
+        last_name = capitalize_string(get_string("Last Name: ", stdin));
+        string_is_valid = is_valid_nonempty_string(last_name);
         if (!string_is_valid)
         {
             printf(RED "Oops! Last name cannot be empty.\n\n" RESET);
@@ -1999,75 +1320,83 @@ void edit_passenger(Passenger *head)
     do
     {
         // Update the current datetime before asking for the birth date
-        update_current_datetime();
+        fdb_update_time(db);
 
-        p_ptr->birth_date = get_date(B_CYAN "--- Date of Birth ---------------------" RESET);
+        birth_date = get_date(B_CYAN "--- Date of Birth ---------------------" RESET);
         printf(B_CYAN "\n---------------------------------------\n" RESET);
-        birthdate_is_valid = is_valid_birthdate(p_ptr->birth_date);
+        birthdate_is_valid = is_valid_birthdate(birth_date, fdb_now(db));
         if (!birthdate_is_valid)
         {
             printf(RED "\nOops! Please enter a valid birth date. The maximum age is %d.\n" RESET, MAX_AGE);
         }
     } while (!birthdate_is_valid);
 
+    // Change the details (and journal them)
+    status = fdb_edit_passenger(db, p_ptr->passport_number, last_name, birth_date);
+    free(last_name);
+    if (status != FDB_OK)
+    {
+        printf("\n");
+        print_status(status);
+        return;
+    }
+
     printf(GREEN "\nSuccess: Edited Passenger %s.\n\n" RESET, p_ptr->first_name);
 }
 
-void book_reservation(Flight *f_head, Passenger *p_head)
+void book_reservation(FlightDB *db)
 {
     // Variables
     Passenger *passenger = NULL;
     Flight *flight = NULL;
-    Reservation *reservation_ptr = NULL;
-    Reservation *new_reservation = NULL;
-    DateTime *d_ptr = NULL, *a_ptr = NULL;
-    FlightStatus status;
+    Flight *conflict = NULL;
     char *passport_number, *flight_id;
     bool available_flights_exists;
+    int status;
 
     printf(B_CYAN "== Book Reservation =======================\n\n" RESET);
 
     // If there are no flights to book and no passengers that can book
-    if (f_head == NULL && p_head == NULL)
+    if (fdb_flights(db) == NULL && fdb_passengers(db) == NULL)
     {
         printf(BLUE "Info: There are currently no flights and passengers.\n\n" RESET);
         return;
     }
     // If there are no flights to book
-    if (f_head == NULL)
+    if (fdb_flights(db) == NULL)
     {
         printf(BLUE "Info: There are currently no flights.\n\n" RESET);
         return;
     }
     // If there are no passengers that can book
-    if (p_head == NULL)
+    if (fdb_passengers(db) == NULL)
     {
         printf(BLUE "Info: There are currently no passengers.\n\n" RESET);
         return;
     }
 
     // Print passengers (in linear form)
-    view_passengers_linear(p_head);
+    view_passengers_linear(fdb_passengers(db));
 
     // Ask for a Passport Number and validate
     passport_number = toupper_string(get_string("Passport Number: ", stdin));
     printf("\n");
     if (!is_valid_passport(passport_number))
     {
-        printf(RED "Oops! A valid Passport Number has 9 uppercase letters and/or digits.\n\n" RESET);
+        print_status(FDB_INVALID_PASSPORT);
         free(passport_number);
         return;
     }
-    if ((passenger = search_passenger_node(p_head, passport_number)) == NULL)
+    if ((passenger = fdb_find_passenger(db, passport_number)) == NULL)
     {
-        printf(RED "Oops! That passenger does not exist.\n\n" RESET);
+        print_status(FDB_PASSENGER_NOT_FOUND);
         free(passport_number);
         return;
     }
     free(passport_number);
 
     // Print flights (in linear form)
-    available_flights_exists = view_flights_linear(f_head, VIEW_FLIGHTS_LINEAR_AVAILABLE);
+    available_flights_exists = view_flights_linear(db, VIEW_FLIGHTS_LINEAR_AVAILABLE);
     if (!available_flights_exists)
     {
         return;
@@ -2078,122 +1407,84 @@ void book_reservation(Flight *f_head, Passenger *p_head)
     printf("\n");
     if (!is_valid_id(flight_id))
     {
-        printf(RED "Oops! A valid Flight ID has at least 1 and at most 6 uppercase letters and/or digits only.\n\n" RESET);
+        print_status(FDB_INVALID_FLIGHT_ID);
         free(flight_id);
         return;
     }
-    if ((flight = search_flight_node(f_head, flight_id)) == NULL)
+    if ((flight = fdb_find_flight(db, flight_id)) == NULL)
     {
-        printf(RED "Oops! That Flight does not exist.\n\n" RESET);
+        print_status(FDB_FLIGHT_NOT_FOUND);
         free(flight_id);
         return;
     }
+    free(flight_id);
 
-    // Retrieve the status of the flight
-    status = retrieve_flight_status(flight);
-
-    if (status.flight_departed)
-    {
-        printf(RED "Oops! That Flight has already departed.\n\n" RESET);
-        free(flight_id);
+    // Reserve the Flight and update flight and passenger details (and journal it)
+    status = fdb_book(db, passenger->passport_number, flight->flight_id);
+    if (status == FDB_CONFLICT)
+    {
+        // Show which reservation the Flight conflicts with
+        conflict = fdb_find_conflict(db, passenger, flight);
+        printf(RED "Oops! That Flight conflicts with current reservations.\n" RESET);
+        printf("Reserving:        ");
+        printf("%6s | %d %s %d %02d:%02d - %d %s %d %02d:%02d\n",
+               flight->flight_id,
+               flight->departure.date.day, int_to_month(flight->departure.date.month), flight->departure.date.year,
+               flight->departure.time.hours, flight->departure.time.minutes,
+               flight->arrival.date.day, int_to_month(flight->arrival.date.month), flight->arrival.date.year,
+               flight->arrival.time.hours, flight->arrival.time.minutes);
+        printf("Conflicting with: ");
+        printf("%6s | %d %s %d %02d:%02d - %d %s %d %02d:%02d\n\n",
+               conflict->flight_id,
+               conflict->departure.date.day, int_to_month(conflict->departure.date.month), conflict->departure.date.year,
+               conflict->departure.time.hours, conflict->departure.time.minutes,
+               conflict->arrival.date.day, int_to_month(conflict->arrival.date.month), conflict->arrival.date.year,
+               conflict->arrival.time.hours, conflict->arrival.time.minutes);
         return;
     }
-    if (flight->passenger_qty == flight->passenger_max)
+    if (status != FDB_OK)
     {
-        printf(RED "Oops! That Flight is fully booked.\n\n" RESET);
-        free(flight_id);
+        print_status(status);
         return;
     }
-    free(flight_id);
-
-    // Start from the head of the Reservations linked list
-    reservation_ptr = passenger->reservations;
-    // Traverse the linked list
-    for (int i = 0; i < passenger->reservation_qty; i++)
-    {
-        // If we already reserved the flight
-        if (reservation_ptr->flight->flight_id == flight->flight_id) // This works because they're the same addresses.
-        {
-            printf(RED "Oops! You already reserved this Flight.\n\n" RESET);
-            return;
-        }
-
-        // DateTime pointers (to shorten the following code)
-        d_ptr = &reservation_ptr->flight->departure;
-        a_ptr = &reservation_ptr->flight->arrival;
-
-        // If the Flight conflicts with the Reservation
-        if (is_conflicting(*d_ptr, *a_ptr, flight->departure, flight->arrival))
-        {
-
-            printf(RED "Oops! That Flight conflicts with current reservations.\n" RESET);
-            printf("Reserving:        ");
-            printf("%6s | %d %s %d %02d:%02d - %d %s %d %02d:%02d\n",
-                   flight->flight_id,
-                   flight->departure.date.day, flight->departure.date.month, flight->departure.date.year,
-                   flight->departure.time.hours, flight->departure.time.minutes,
-                   flight->arrival.date.day, flight->arrival.date.month, flight->arrival.date.year,
-                   flight->arrival.time.hours, flight->arrival.time.minutes);
-            printf("Conflicting with: ");
-            printf("%6s | %d %s %d %02d:%02d - %d %s %d %02d:%02d\n\n",
-                   reservation_ptr->flight->flight_id,
-                   d_ptr->date.day, d_ptr->date.month, d_ptr->date.year,
-                   d_ptr->time.hours, d_ptr->time.minutes,
-                   a_ptr->date.day, a_ptr->date.month, a_ptr->date.year,
-                   a_ptr->time.hours, a_ptr->time.minutes);
-            return;
-        }
-        reservation_ptr = reservation_ptr->next;
-    }
-
-    // Create a new Reservation node
-    new_reservation = create_reservation_node(flight);
-
-    // Insert the Reservation node to the passenger's reservations linked list
-    insert_reservation_node(&passenger->reservations, new_reservation);
-
-    // Update flight and passenger details
-    flight->passenger_qty++;
-    passenger->reservation_qty++;
-    passenger->miles += flight->bonus_miles;
 
     // Print success message
     printf(GREEN "Success: Reserved Flight %s for %s.\n\n" RESET, flight->flight_id, passenger->first_name);
 }
 
-void remove_reservation(Flight *f_head, Passenger *p_head)
+void remove_reservation(FlightDB *db)
 {
     // Variables
     char *passport_number, *flight_id;
     Passenger *passenger = NULL;
     Flight *flight = NULL;
-    Reservation *r_ptr = NULL;
-    FlightStatus status;
+    FlightStatus flight_status;
+    int status;
 
     printf(B_CYAN "== Remove Reservation =====================\n\n" RESET);
 
     // If there are no passengers to remove reservations from
-    if (p_head == NULL)
+    if (fdb_passengers(db) == NULL)
     {
         printf(BLUE "Info: There are currently no passengers.\n\n" RESET);
         return;
     }
 
     // Print passengers (in linear form)
-    view_passengers_linear(p_head);
+    view_passengers_linear(fdb_passengers(db));
 
     // Ask for a Passport Number and validate
     passport_number = toupper_string(get_string("Passport Number: ", stdin));
     printf("\n");
     if (!is_valid_passport(passport_number))
     {
-        printf(RED "Oops! A valid Passport Number has 9 uppercase letters and/or digits.\n\n" RESET);
+        print_status(FDB_INVALID_PASSPORT);
         free(passport_number);
         return;
     }
-    if ((passenger = search_passenger_node(p_head, passport_number)) == NULL)
+    if ((passenger = fdb_find_passenger(db, passport_number)) == NULL)
     {
-        printf(RED "Oops! That passenger does not exist.\n\n" RESET);
+        print_status(FDB_PASSENGER_NOT_FOUND);
         free(passport_number);
         return;
     }
@@ -2213,56 +1504,53 @@ void remove_reservation(Flight *f_head, Passenger *p_head)
     printf("\n");
     if (!is_valid_id(flight_id))
     {
-        printf(RED "Oops! A valid Flight ID has at least 1 and at most 6 uppercase letters and/or digits only.\n\n" RESET);
+        print_status(FDB_INVALID_FLIGHT_ID);
         free(flight_id);
         return;
     }
-    if ((flight = search_flight_node(f_head, flight_id)) == NULL)
+    if ((flight = fdb_find_flight(db, flight_id)) == NULL)
     {
-        printf(RED "Oops! That Flight does not exist.\n\n" RESET);
+        print_status(FDB_FLIGHT_NOT_FOUND);
         free(flight_id);
         return;
     }
     free(flight_id);
 
     // Search for the Reservation to delete
-    if ((r_ptr = search_reservation_node(passenger->reservations, flight)) == NULL)
+    if (search_reservation_node(passenger->reservations, flight) == NULL)
     {
-        printf(RED "Oops! That reservation does not exist for that passenger.\n\n" RESET);
+        print_status(FDB_RESERVATION_NOT_FOUND);
         return;
     }
 
     // Get the current status of the flight we are trying to remove
-    status = retrieve_flight_status(flight);
+    flight_status = fdb_flight_status(db, flight);
 
-    if (status.flight_departed && !status.flight_arrived)
+    if (flight_status.flight_departed && !flight_status.flight_arrived)
     {
-        printf(RED "Oops! You cannot remove an ongoing flight from your reservations.\n\n");
+        print_status(FDB_RESERVATION_ONGOING);
         return;
     }
 
     // Confirm deletion of Reservation
     if (confirm_delete("Do you want to delete this Reservation? (y/n): "))
     {
-        // Update flight and passenger details
-        r_ptr->flight->passenger_qty--;
-        passenger->reservation_qty--;
-
-        // If the flight has not yet departed, this removal is a cancellation of the flight.
-        // We revoke the bonus miles gained from this reservation.
-        if (!status.flight_departed)
+        // Update flight and passenger details and delete the Reservation (and journal it)
+        // If the flight has not yet departed, this removal is a cancellation of the flight, which revokes its bonus miles.
+        if ((status = fdb_cancel(db, passenger->passport_number, flight->flight_id)) != FDB_OK)
         {
-            passenger->miles -= r_ptr->flight->bonus_miles;
-            printf(GREEN "Success: Cancelled reserved flight %s for %s.\n\n" RESET, r_ptr->flight->flight_id, passenger->first_name);
+            print_status(status);
+        }
+        else if (!flight_status.flight_departed)
+        {
+            printf(GREEN "Success: Cancelled reserved flight %s for %s.\n\n" RESET, flight->flight_id, passenger->first_name);
         }
         // If the flight has departed (and ended), this removal is not a cancellation of the flight.
-        // We do not revoke the bonus miles gained from this reservation.
+        // The bonus miles gained from this reservation are kept.
         else
         {
-            printf(GREEN "Success: Removed finished flight %s for %s.\n\n" RESET, r_ptr->flight->flight_id, passenger->first_name);
+            printf(GREEN "Success: Removed finished flight %s for %s.\n\n" RESET, flight->flight_id, passenger->first_name);
         }
-
-        delete_reservation_node(&passenger->reservations, r_ptr->flight);
     }
     else
     {
@@ -2270,39 +1558,37 @@ void remove_reservation(Flight *f_head, Passenger *p_head)
     }
 }
 
-void view_reservations(Passenger *head)
+void view_reservations(FlightDB *db)
 {
     // Variables
     char *passport_number;
     Passenger *p_ptr = NULL;
-    Flight *f_ptr = NULL;
     Reservation *r_ptr = NULL;
-    FlightStatus status;
 
     printf(B_CYAN "== View Reservations ======================\n\n" RESET);
 
     // If there are no passengers to view reservations from
-    if (head == NULL)
+    if (fdb_passengers(db) == NULL)
     {
         printf(BLUE "Info: There are currently no passengers.\n\n" RESET);
         return;
     }
 
     // Print passengers (in linear form)
-    view_passengers_linear(head);
+    view_passengers_linear(fdb_passengers(db));
 
     // Ask for a Passport Number and validate
     passport_number = toupper_string(get_string("Passport Number: ", stdin));
     printf("\n");
     if (!is_valid_passport(passport_number))
     {
-        printf(RED "Oops! A valid Passport Number has 9 uppercase letters and/or digits.\n\n" RESET);
+        print_status(FDB_INVALID_PASSPORT);
         free(passport_number);
         return;
     }
-    if ((p_ptr = search_passenger_node(head, passport_number)) == NULL)
+    if ((p_ptr = fdb_find_passenger(db, passport_number)) == NULL)
     {
-        printf(RED "Oops! That passenger does not exist.\n\n" RESET);
+        print_status(FDB_PASSENGER_NOT_FOUND);
         free(passport_number);
         return;
     }
@@ -2321,99 +1607,58 @@ void view_reservations(Passenger *head)
     // Traverse and print each reservation
     while (r_ptr != NULL)
     {
-        print_flight(r_ptr->flight);
+        print_flight(db, r_ptr->flight);
         printf("\n");
         r_ptr = r_ptr->next;
     }
 }
 
-bool view_flights_linear(Flight *head, int mode)
+bool view_flights_linear(FlightDB *db, int mode)
 {
     // Variables
     int count = 0;
-    int max_origin_length = 0, max_destination_length = 0;
-    int max_departure_month_length = 0, max_arrival_month_length = 0;
-    Flight *ptr = head;
+    Flight *ptr = fdb_flights(db);
+    int position = 0;
     FlightStatus status;
+    OutputBuffer out;
+    const ColumnWidths *widths = fdb_column_widths(db, false);
 
-    // First Pass: Get the maximum lengths of the strings for formatting
-    while (ptr != NULL)
+    // Mode 1 only walks the bookable Flights (instead of every Flight ever added)
+    if (mode == VIEW_FLIGHTS_LINEAR_AVAILABLE)
     {
-        // Get the lengths of the strings
-        int origin_length = strlen(ptr->origin);
-        int destination_length = strlen(ptr->destination);
-        int departure_month_length = strlen(ptr->departure.date.month);
-        int arrival_month_length = strlen(ptr->arrival.date.month);
-
-        // Check if we need to calculate the maximum lengths
-        bool calculate_length = false;
-        switch (mode)
-        {
-        case 1: // Mode 1: Available Flights (for Booking)
-            status = retrieve_flight_status(ptr);
-            if (ptr->passenger_qty < ptr->passenger_max && !status.flight_departed)
-            {
-                calculate_length = true;
-            }
-            break;
-        case 2: // Mode 2: Empty/Removable Flights (for Deleting)
-            status = retrieve_flight_status(ptr);
-            if (ptr->passenger_qty == 0 || status.flight_arrived)
-            {
-                calculate_length = true;
-            }
-            break;
-        case 3: // Mode 3: All Flights (for Viewing)
-            calculate_length = true;
-            break;
-        }
-
-        // Calculate the maximum lengths if it fits the criteria
-        if (calculate_length)
-        {
-            if (max_origin_length < origin_length)
-            {
-                max_origin_length = origin_length;
-            }
-            if (max_destination_length < destination_length)
-            {
-                max_destination_length = destination_length;
-            }
-            if (max_departure_month_length < departure_month_length)
-            {
-                max_departure_month_length = departure_month_length;
-            }
-            if (max_arrival_month_length < arrival_month_length)
-            {
-                max_arrival_month_length = arrival_month_length;
-            }
-        }
-
-        ptr = ptr->next;
+        ptr = fdb_available_flight(db, 0);
+        widths = fdb_column_widths(db, true);
     }
 
+    // The column widths are kept up to date as Flights change, so the rows are formatted in one pass
+    // (the removable Flights line up with every Flight, which may be a little wider than they need)
+    int max_origin_length = column_width(widths->origin);
+    int max_destination_length = column_width(widths->destination);
+    int max_departure_month_length = column_width(widths->departure_month);
+    int max_arrival_month_length = column_width(widths->arrival_month);
+
+    output_init(&out);
     switch (mode)
     {
     case 1:
-        printf(B_CYAN "--- Available Flights -----------------\n\n" RESET);
+        output_printf(&out, B_CYAN "--- Available Flights -----------------\n\n" RESET);
         break;
     case 2:
-        printf(B_CYAN "--- Empty/Removable Flights -----------\n\n" RESET);
+        output_printf(&out, B_CYAN "--- Empty/Removable Flights -----------\n\n" RESET);
         break;
     case 3:
-        printf(B_CYAN "--- All Flights -----------------------\n\n" RESET);
+        output_printf(&out, B_CYAN "--- All Flights -----------------------\n\n" RESET);
         break;
     }
 
-    // Second Pass: Print the flights
-    ptr = head;
-    while (ptr != NULL)
+    // Format the flights
+    while (ptr != NULL && !out.stopped)
     {
         bool should_print = false;
         switch (mode)
         {
         case 1: // Mode 1: Available Flights (for Booking)
-            status = retrieve_flight_status(ptr);
+            status = fdb_flight_status(db, ptr);
             if (ptr->passenger_qty < ptr->passenger_max && !status.flight_departed)
             {
                 should_print = true;
@@ -2422,7 +1667,7 @@ bool view_flights_linear(Flight *head, int mode)
         case 2: // Mode 2: Empty/Removable Flights (for Deleting)
 
             // Get the current status of the flight
-            status = retrieve_flight_status(ptr);
+            status = fdb_flight_status(db, ptr);
 
             // The flight is removable if there are no passengers or the flight has already arrived.
             if (ptr->passenger_qty == 0 || status.flight_arrived)
@@ -2435,18 +1680,19 @@ bool view_flights_linear(Flight *head, int mode)
             break;
         }
 
-        // Print the flight if it fits the criteria
+        // Format the flight if it fits the criteria
         if (should_print)
         {
-            printf("%6s | %-*s to %-*s | %02d %-*s %02d %02d:%02d - %02d %-*s %02d %02d:%02d\n",
-                   ptr->flight_id, max_origin_length, ptr->origin, max_destination_length, ptr->destination,
-                   ptr->departure.date.day, max_departure_month_length, ptr->departure.date.month, ptr->departure.date.year,
-                   ptr->departure.time.hours, ptr->departure.time.minutes,
-                   ptr->arrival.date.day, max_arrival_month_length, ptr->arrival.date.month, ptr->arrival.date.year,
-                   ptr->arrival.time.hours, ptr->arrival.time.minutes);
+            output_printf(&out, "%6s | %-*s to %-*s | %02d %-*s %02d %02d:%02d - %02d %-*s %02d %02d:%02d\n",
+                          ptr->flight_id, max_origin_length, ptr->origin, max_destination_length, ptr->destination,
+                          ptr->departure.date.day, max_departure_month_length, int_to_month(ptr->departure.date.month), ptr->departure.date.year,
+                          ptr->departure.time.hours, ptr->departure.time.minutes,
+                          ptr->arrival.date.day, max_arrival_month_length, int_to_month(ptr->arrival.date.month), ptr->arrival.date.year,
+                          ptr->arrival.time.hours, ptr->arrival.time.minutes);
+            output_page(&out);
             count++;
         }
-        ptr = ptr->next;
+        ptr = (mode == VIEW_FLIGHTS_LINEAR_AVAILABLE) ? fdb_available_flight(db, ++position) : ptr->next;
     }
 
     // If no flights fit the criteria
@@ -2455,20 +1701,26 @@ bool view_flights_linear(Flight *head, int mode)
         switch (mode)
         {
         case 1:
-            printf(BLUE "Info: No flights are available.\n\n" RESET);
+            output_printf(&out, BLUE "Info: No flights are available.\n\n" RESET);
             break;
         case 2:
-            printf(BLUE "Info: No flights are empty/removable.\n\n" RESET);
+            output_printf(&out, BLUE "Info: No flights are empty/removable.\n\n" RESET);
             break;
         case 3:
-            printf(BLUE "Info: No flights are found.\n\n" RESET);
+            output_printf(&out, BLUE "Info: No flights are found.\n\n" RESET);
             break;
         }
-        return false;
+    }
+    else
+    {
+        output_printf(&out, "\n");
     }
 
-    printf("\n");
-    return true;
+    // Write the whole screen at once
+    output_flush(&out);
+    free_output_buffer(&out);
+
+    return count != 0;
 }
 
 void view_passengers_linear(Passenger *head)
@@ -2535,8 +1787,8 @@ void view_reservations_linear(Reservation *head)
 
         int origin_length = strlen(f_ptr->origin);
         int destination_length = strlen(f_ptr->destination);
-        int departure_month_length = strlen(f_ptr->departure.date.month);
-        int arrival_month_length = strlen(f_ptr->arrival.date.month);
+        int departure_month_length = strlen(int_to_month(f_ptr->departure.date.month));
+        int arrival_month_length = strlen(int_to_month(f_ptr->arrival.date.month));
 
         if (max_origin_length < origin_length)
         {
@@ -2568,49 +1820,65 @@ void view_reservations_linear(Reservation *head)
         f_ptr = r_ptr->flight;
         printf("%6s | %-*s to %-*s | %02d %-*s %02d %02d:%02d - %02d %-*s %02d %02d:%02d\n",
                f_ptr->flight_id, max_origin_length, f_ptr->origin, max_destination_length, f_ptr->destination,
-               f_ptr->departure.date.day, max_departure_month_length, f_ptr->departure.date.month, f_ptr->departure.date.year,
+               f_ptr->departure.date.day, max_departure_month_length, int_to_month(f_ptr->departure.date.month), f_ptr->departure.date.year,
                f_ptr->departure.time.hours, f_ptr->departure.time.minutes,
-               f_ptr->arrival.date.day, max_arrival_month_length, f_ptr->arrival.date.month, f_ptr->arrival.date.year,
+               f_ptr->arrival.date.day, max_arrival_month_length, int_to_month(f_ptr->arrival.date.month), f_ptr->arrival.date.year,
                f_ptr->arrival.time.hours, f_ptr->arrival.time.minutes);
         r_ptr = r_ptr->next;
     }
     printf("\n");
 }
 
-void print_flight(Flight *flight)
+void print_flight(FlightDB *db, Flight *flight)
 {
-    // Retrieve the Flight Status
-    FlightStatus status = retrieve_flight_status(flight);
+    // Format the Flight and write it at once
+    OutputBuffer out;
+    output_init(&out);
+    render_flight(db, &out, flight);
+    output_flush(&out);
+    free_output_buffer(&out);
+}
 
-    printf(YELLOW "Flight ID: %s\n" RESET, flight->flight_id);
-    printf("Flight:    %s to %s\n", flight->origin, flight->destination);
+void render_flight(FlightDB *db, OutputBuffer *out, Flight *flight)
+{
+    // Retrieve the Flight Status
+    FlightStatus status = fdb_flight_status(db, flight);
+    const char *status_line;
 
     if (status.flight_departed && !status.flight_arrived)
     {
-        printf(RED "- Status:    Ongoing\n" RESET);
+        status_line = RED "- Status:    Ongoing\n" RESET;
     }
     else if (status.flight_arrived)
     {
-        printf(BLUE "- Status:    Arrived\n" RESET);
+        status_line = BLUE "- Status:    Arrived\n" RESET;
     }
     else if (flight->passenger_qty == flight->passenger_max)
     {
-        printf(RED "- Status:    Fully-booked\n" RESET);
+        status_line = RED "- Status:    Fully-booked\n" RESET;
     }
     else
     {
-        printf(GREEN "- Status:    Available\n" RESET);
+        status_line = GREEN "- Status:    Available\n" RESET;
     }
 
-    printf("- Departure: %d %s %d - %02d:%02d\n",
-           flight->departure.date.day, flight->departure.date.month, flight->departure.date.year,
-           flight->departure.time.hours, flight->departure.time.minutes);
-    printf("- Arrival:   %d %s %d - %02d:%02d\n",
-           flight->arrival.date.day, flight->arrival.date.month, flight->arrival.date.year,
-           flight->arrival.time.hours, flight->arrival.time.minutes);
-    printf("Passengers:  %d\n", flight->passenger_qty);
-    printf("Max Seats:   %d\n", flight->passenger_max);
-    printf("Bonus Miles: %d\n", flight->bonus_miles);
+    // Format every line of the Flight at once
+    output_printf(out, YELLOW "Flight ID: %s\n" RESET
+                               "Flight:    %s to %s\n"
+                               "%s"
+                               "- Departure: %d %s %d - %02d:%02d\n"
+                               "- Arrival:   %d %s %d - %02d:%02d\n"
+                               "Passengers:  %d\n"
+                               "Max Seats:   %d\n"
+                               "Bonus Miles: %d\n",
+                  flight->flight_id,
+                  flight->origin, flight->destination,
+                  status_line,
+                  flight->departure.date.day, int_to_month(flight->departure.date.month), flight->departure.date.year,
+                  flight->departure.time.hours, flight->departure.time.minutes,
+                  flight->arrival.date.day, int_to_month(flight->arrival.date.month), flight->arrival.date.year,
+                  flight->arrival.time.hours, flight->arrival.time.minutes,
+                  flight->passenger_qty, flight->passenger_max, flight->bonus_miles);
 }
 
 void print_passenger(Passenger *passenger)
@@ -2620,7 +1888,7 @@ void print_passenger(Passenger *passenger)
 
     printf(YELLOW "Passport Number: %s\n" RESET, passenger->passport_number);
     printf("Name:         %s, %s\n" RESET, passenger->last_name, passenger->first_name);
-    printf("Birth Date:   %02d %s %d\n" RESET, passenger->birth_date.day, passenger->birth_date.month, passenger->birth_date.year);
+    printf("Birth Date:   %02d %s %d\n" RESET, passenger->birth_date.day, int_to_month(passenger->birth_date.month), passenger->birth_date.year);
     printf("Reservations: %d\n" RESET, passenger->reservation_qty);
     printf("- ");
     while (r_ptr != NULL)
@@ -2632,252 +1900,292 @@ void print_passenger(Passenger *passenger)
     printf("Miles:        %d\n" RESET, passenger->miles);
 }
 
-void load_flights(Flight **f_head, FILE *fp)
+void view_manifest_linear(Flight *flight)
 {
-    // Variable
-    int flight_count = 0;
+    // Variables
+    Reservation *r_ptr = flight->manifest;
+    int max_name_length = 0;
+
+    // If nobody booked the flight
+    if (r_ptr == NULL)
+    {
+        printf(BLUE "Info: No passengers have booked this Flight.\n\n" RESET);
+        return;
+    }
 
-    fscanf(fp, "%d\n", &flight_count); // Read the flight count
-    if (flight_count != 0)             // If there are flights
+    // First Pass: Get the maximum length of the names for formatting
+    while (r_ptr != NULL)
     {
-        while (!feof(fp)) // While there are flights to read
+        int name_length = strlen(r_ptr->passenger->first_name) + strlen(r_ptr->passenger->last_name);
+        if (max_name_length < name_length)
         {
-            // Create a Flight node
-            Flight *f_temp = create_flight_node();
+            max_name_length = name_length;
+        }
+        r_ptr = r_ptr->manifest_next;
+    }
 
-            // Scan each field from the file
-            f_temp->flight_id = get_string(NULL, fp);
-            f_temp->origin = get_string(NULL, fp);
-            f_temp->destination = get_string(NULL, fp);
-            fscanf(fp, "%d %s %d - %d:%d\n",
-                   &f_temp->departure.date.day, f_temp->departure.date.month, &f_temp->departure.date.year,
-                   &f_temp->departure.time.hours, &f_temp->departure.time.minutes);
-            fscanf(fp, "%d %s %d - %d:%d\n",
-                   &f_temp->arrival.date.day, f_temp->arrival.date.month, &f_temp->arrival.date.year,
-                   &f_temp->arrival.time.hours, &f_temp->arrival.time.minutes);
-            fscanf(fp, "%d\n", &f_temp->passenger_qty);
-            fscanf(fp, "%d\n", &f_temp->passenger_max);
-            fscanf(fp, "%d\n", &f_temp->bonus_miles);
+    printf(B_CYAN "--- Manifest --------------------------\n\n" RESET);
 
-            // Insert the Flight to the Linked List
-            insert_flight_node(&(*f_head), f_temp);
-        }
+    // Second Pass: Print the passengers (most recent booking first)
+    r_ptr = flight->manifest;
+    while (r_ptr != NULL)
+    {
+        Passenger *p_ptr = r_ptr->passenger;
+        int padding = max_name_length - (int)(strlen(p_ptr->first_name) + strlen(p_ptr->last_name));
+        printf("%9s | %s, %s%*s | %d miles\n",
+               p_ptr->passport_number, p_ptr->last_name, p_ptr->first_name, padding, "", p_ptr->miles);
+        r_ptr = r_ptr->manifest_next;
     }
+    printf("\n");
 }
-
-void load_passengers(Flight *f_head, Passenger **p_head, FILE *fp)
+void run_batch(FlightDB *db, char *filename)
 {
     // Variables
-    int passenger_count = 0;
-    Flight *reserved_flight;
-    Reservation *r_ptr;
+    char *fields[BATCH_MAX_FIELDS];
+    struct timespec begin, finish;
+    int line_number = 0, succeeded = 0, failed = 0, status;
+    LineReader reader;
+    StringView line;
 
-    fscanf(fp, "%d\n", &passenger_count); // Read the passenger count
-    if (passenger_count == 0)             // If there are no passengers
+    // Read the commands from the file, or from stdin (a pipe) if there is none
+    FILE *fp = stdin;
+    if (filename != NULL && strcmp(filename, "-") != 0)
     {
-        return;
+        if ((fp = fopen(filename, "r")) == NULL)
+        {
+            printf(RED "Error opening %s\n" RESET, filename);
+            return;
+        }
     }
 
-    while (!feof(fp)) // While there are passengers to read
-    {
-        // Create a Passenger node
-        Passenger *p_temp = create_passenger_node();
+    // Every command is checked against one clock snapshot, and the journal is synced once at the end
+    fdb_update_time(db);
+    fdb_begin_batch(db);
 
-        // Scan each field from the file
-        p_temp->last_name = get_string(NULL, fp);
-        p_temp->first_name = get_string(NULL, fp);
-        p_temp->passport_number = get_string(NULL, fp);
-        fscanf(fp, "%d %s %d\n",
-               &p_temp->birth_date.day,
-               p_temp->birth_date.month,
-               &p_temp->birth_date.year);
-        fscanf(fp, "%d\n", &p_temp->reservation_qty);
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    line_reader_init(&reader, fp);
+    while (line_reader_next(&reader, &line))
+    {
+        line_number++;
 
-        // Read the reservations
-        for (int i = 0; i < p_temp->reservation_qty; i++)
+        // Split the line (blank lines and # comments are skipped)
+        int count = split_fields((char *)line.data, fields, BATCH_MAX_FIELDS);
+        if (count == 0 || fields[0][0] == '#')
+        {
+            continue;
+        }
+        if (count < 0)
         {
-            // Get the Flight ID
-            char *flight_id = get_string(NULL, fp);
+            batch_error(line_number, "Too many fields or an unclosed quote.");
+            failed++;
+            continue;
+        }
 
-            // Search for the flight
-            reserved_flight = search_flight_node(f_head, flight_id);
-            if (reserved_flight == NULL)
+        // Find the command and check its number of fields
+        int command = -1;
+        for (int i = 0; i < BATCH_COMMAND_COUNT; i++)
+        {
+            if (strcmp(fields[0], BATCH_COMMANDS[i]) == 0)
             {
-                printf(RED "Oops! Critical error. Flight missing from flights.txt file.\nCannot continue.\n" RESET);
-                printf(BLUE "Info: This may have happened because files were edited manually.\n\n" RESET);
-                free_passenger_node(p_temp);
-                clean_exit();
+                command = i;
             }
+        }
+        if (command == -1)
+        {
+            batch_error(line_number, "Unknown command '%s'.", fields[0]);
+            failed++;
+            continue;
+        }
+        if (count - 1 != BATCH_COMMAND_FIELDS[command])
+        {
+            batch_error(line_number, "%s takes %d field(s), not %d.", BATCH_COMMANDS[command], BATCH_COMMAND_FIELDS[command], count - 1);
+            failed++;
+            continue;
+        }
 
-            free(flight_id); // Free the string
-
-            // Create a Reservation node
-            r_ptr = create_reservation_node(reserved_flight);
-
-            // Insert the Reservation node to the passenger's reservations linked list
-            insert_reservation_node(&p_temp->reservations, r_ptr);
+        // Run the command
+        if (batch_apply(db, command, &fields[1], line_number))
+        {
+            succeeded++;
+        }
+        else
+        {
+            failed++;
         }
-        fscanf(fp, "%d\n", &p_temp->miles);
 
-        // Insert to the Passengers linked list
-        insert_passenger_node(&(*p_head), p_temp);
+        // Fold the journal into a new save once it grows too large
+        if ((status = fdb_maintain(db)) != FDB_OK)
+        {
+            print_status(status);
+        }
     }
-}
+    free_line_reader(&reader);
+    clock_gettime(CLOCK_MONOTONIC, &finish);
 
-void load(Flight **f_head, Passenger **p_head)
-{
-    // Load Flights
-    FILE *fp = fopen(FLIGHTS_FILE, "r");
-    if (fp != NULL) // If the file exists
+    // Sync every journal record of the batch at once
+    fdb_end_batch(db);
+    if (fp != stdin)
     {
-        load_flights(&(*f_head), fp);
         fclose(fp);
     }
 
-    // Load Passengers
-    fp = fopen(PASSENGERS_FILE, "r");
-    if (fp != NULL) // If both files exist
-    {
-        load_passengers(*f_head, &(*p_head), fp);
-        fclose(fp);
-    }
+    // Report the throughput
+    double seconds = (finish.tv_sec - begin.tv_sec) + (finish.tv_nsec - begin.tv_nsec) / 1e9;
+    int total = succeeded + failed;
+    printf("Batch: %d command(s) in %.3f s (%.0f ops/sec)\n", total, seconds, (seconds > 0) ? total / seconds : 0.0);
+    printf("- Succeeded: %d\n", succeeded);
+    printf("- Failed:    %d\n", failed);
 }
 
-void save_flights(Flight *f_head, FILE *fp)
+bool batch_apply(FlightDB *db, int command, char **fields, int line_number)
 {
     // Variables
-    int flight_count = count_flights(f_head);
-    Flight *f_ptr = f_head;
-
-    // Write the Flight count
-    fprintf(fp, "%d\n", flight_count);
-
-    // Print each Flight detail to the file
-    while (f_ptr != NULL)
-    {
-        fprintf(fp, "%s\n", f_ptr->flight_id);
-        fprintf(fp, "%s\n", f_ptr->origin);
-        fprintf(fp, "%s\n", f_ptr->destination);
-        fprintf(fp, "%d %s %d - %02d:%02d\n",
-                f_ptr->departure.date.day, f_ptr->departure.date.month, f_ptr->departure.date.year,
-                f_ptr->departure.time.hours, f_ptr->departure.time.minutes);
-        fprintf(fp, "%d %s %d - %02d:%02d\n",
-                f_ptr->arrival.date.day, f_ptr->arrival.date.month, f_ptr->arrival.date.year,
-                f_ptr->arrival.time.hours, f_ptr->arrival.time.minutes);
-        fprintf(fp, "%d\n", f_ptr->passenger_qty);
-        fprintf(fp, "%d\n", f_ptr->passenger_max);
-        fprintf(fp, "%d\n", f_ptr->bonus_miles);
-
-        f_ptr = f_ptr->next;
-    }
-}
+    Flight *flight = NULL;
+    Date date;
+    Time time, duration;
+    int seats, miles;
+    int status = FDB_OK;
 
-void save_passengers(Passenger *p_head, FILE *fp)
-{
-    // Variables
-    int passenger_count = count_passengers(p_head);
-    Passenger *p_ptr = p_head;
-    Reservation *r_ptr = NULL;
+    switch (command)
+    {
+    case BATCH_ADD_FLIGHT: // ID, origin, destination, departure date, departure time, duration, max seats, bonus miles
+        toupper_string(fields[0]);
+        capitalize_string(fields[1]);
+        capitalize_string(fields[2]);
+        if (!parse_batch_date(fields[3], &date) || !parse_batch_time(fields[4], &time))
+        {
+            return batch_error(line_number, "The departure must be a valid YYYY-MM-DD date and HH:MM time.");
+        }
+        if (!parse_batch_time(fields[5], &duration))
+        {
+            return batch_error(line_number, "%s", fdb_status_message(FDB_INVALID_DURATION));
+        }
+        if (!parse_batch_int(fields[6], &seats))
+        {
+            return batch_error(line_number, "%s", fdb_status_message(FDB_INVALID_SEATS));
+        }
+        if (!parse_batch_int(fields[7], &miles))
+        {
+            return batch_error(line_number, "%s", fdb_status_message(FDB_INVALID_BONUS_MILES));
+        }
+        status = fdb_add_flight(db, fields[0], fields[1], fields[2], (DateTime){.date = date, .time = time}, duration, seats, miles);
+        break;
 
-    // Write the Passenger count
-    fprintf(fp, "%d\n", passenger_count);
+    case BATCH_EDIT_FLIGHT: // ID, departure date, departure time, duration, max seats
+        toupper_string(fields[0]);
+        if (!parse_batch_date(fields[1], &date) || !parse_batch_time(fields[2], &time))
+        {
+            return batch_error(line_number, "The departure must be a valid YYYY-MM-DD date and HH:MM time.");
+        }
+        if (!parse_batch_time(fields[3], &duration))
+        {
+            return batch_error(line_number, "%s", fdb_status_message(FDB_INVALID_DURATION));
+        }
+        if (!parse_batch_int(fields[4], &seats))
+        {
+            return batch_error(line_number, "%s", fdb_status_message(FDB_INVALID_SEATS));
+        }
+        status = fdb_edit_flight(db, fields[0], (DateTime){.date = date, .time = time}, duration, seats);
+        break;
 
-    // Write each Passenger detail to the file
-    while (p_ptr != NULL)
-    {
-        fprintf(fp, "%s\n", p_ptr->last_name);
-        fprintf(fp, "%s\n", p_ptr->first_name);
-        fprintf(fp, "%s\n", p_ptr->passport_number);
-        fprintf(fp, "%d %s %d\n",
-                p_ptr->birth_date.day, p_ptr->birth_date.month, p_ptr->birth_date.year);
-        fprintf(fp, "%d\n", p_ptr->reservation_qty);
-        r_ptr = p_ptr->reservations;
-        for (int i = 0; i < p_ptr->reservation_qty; i++)
+    case BATCH_DELETE_FLIGHT: // ID
+        // Say which reservations an arrived Flight takes with it (like delete_flight())
+        flight = fdb_find_flight(db, toupper_string(fields[0]));
+        if (flight != NULL && fdb_flight_status(db, flight).flight_arrived)
         {
-            fprintf(fp, "%s\n", r_ptr->flight->flight_id);
-            r_ptr = r_ptr->next;
+            print_removed_reservations(flight);
         }
-        fprintf(fp, "%d\n", p_ptr->miles);
+        status = fdb_delete_flight(db, fields[0]);
+        break;
 
-        p_ptr = p_ptr->next;
-    }
-}
+    case BATCH_ADD_PASSENGER: // passport number, first name, last name, birth date, miles
+        toupper_string(fields[0]);
+        capitalize_string(fields[1]);
+        capitalize_string(fields[2]);
+        if (!parse_batch_date(fields[3], &date))
+        {
+            return batch_error(line_number, "Please enter a valid YYYY-MM-DD birth date. The maximum age is %d.", MAX_AGE);
+        }
+        if (!parse_batch_int(fields[4], &miles))
+        {
+            return batch_error(line_number, "%s", fdb_status_message(FDB_INVALID_MILES));
+        }
+        status = fdb_add_passenger(db, fields[0], fields[1], fields[2], date, miles);
+        break;
 
-void save(Flight *f_head, Passenger *p_head)
-{
-    // Move files one tier up
-    create_backups(FLIGHTS_FILE, PASSENGERS_FILE);
+    case BATCH_EDIT_PASSENGER: // passport number, last name, birth date
+        toupper_string(fields[0]);
+        capitalize_string(fields[1]);
+        if (!parse_batch_date(fields[2], &date))
+        {
+            return batch_error(line_number, "Please enter a valid YYYY-MM-DD birth date. The maximum age is %d.", MAX_AGE);
+        }
+        status = fdb_edit_passenger(db, fields[0], fields[1], date);
+        break;
 
-    // Save Flights
-    FILE *flights_fp = fopen(FLIGHTS_FILE, "w");
-    if (flights_fp != NULL)
-    {
-        save_flights(f_head, flights_fp);
-        fclose(flights_fp);
+    case BATCH_BOOK: // passport number, flight ID
+        status = fdb_book(db, toupper_string(fields[0]), toupper_string(fields[1]));
+        break;
+
+    case BATCH_CANCEL: // passport number, flight ID
+        // Cancelling a Flight that has not departed revokes its bonus miles (like remove_reservation())
+        status = fdb_cancel(db, toupper_string(fields[0]), toupper_string(fields[1]));
+        break;
     }
 
-    // Save Passengers
-    FILE *passengers_fp = fopen(PASSENGERS_FILE, "w");
-    if (passengers_fp != NULL)
+    // Say why the database refused the command
+    if (status != FDB_OK)
     {
-        save_passengers(p_head, passengers_fp);
-        fclose(passengers_fp);
+        return batch_error(line_number, "%s", fdb_status_message(status));
     }
+    return true;
 }
 
-void create_backups(char *flights_filename, char *passengers_filename)
+bool batch_error(int line_number, const char *format, ...)
 {
     // Variables
-    char old_flights_filename[MAX_FILENAME_LENGTH], old_passengers_filename[MAX_FILENAME_LENGTH];
-    char new_flights_filename[MAX_FILENAME_LENGTH], new_passengers_filename[MAX_FILENAME_LENGTH];
+    va_list args;
 
-    // Shift the backups up by one
-    for (int i = MAX_BACKUPS - 1; i > 0; i--)
-    {
-        snprintf(old_flights_filename, MAX_FILENAME_LENGTH, "backup_%d_%s", i, FLIGHTS_FILE);
-        snprintf(old_passengers_filename, MAX_FILENAME_LENGTH, "backup_%d_%s", i, PASSENGERS_FILE);
-        snprintf(new_flights_filename, MAX_FILENAME_LENGTH, "backup_%d_%s", i + 1, FLIGHTS_FILE);
-        snprintf(new_passengers_filename, MAX_FILENAME_LENGTH, "backup_%d_%s", i + 1, PASSENGERS_FILE);
+    // Print the message after the line it is about
+    printf(RED "Oops! Line %d: ", line_number);
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+    printf("\n" RESET);
 
-        if (file_exists(old_flights_filename) && file_exists(old_passengers_filename))
-        {
-            if (rename(old_flights_filename, new_flights_filename) != 0)
-            {
-                printf(RED "Error moving %s to %s\n" RESET, old_flights_filename, new_flights_filename);
-                return;
-            }
-            if (rename(old_passengers_filename, new_passengers_filename) != 0)
-            {
-                printf(RED "Error moving %s to %s\n" RESET, old_passengers_filename, new_passengers_filename);
-                return;
-            }
-        }
+    return false;
+}
+
+bool parse_batch_date(char *string, Date *date)
+{
+    // The whole string must be YYYY-MM-DD and name a real day
+    int length = 0;
+    if (sscanf(string, "%d-%d-%d%n", &date->year, &date->month, &date->day, &length) != 3 || string[length] != '\0')
+    {
+        return false;
     }
+    return date->month >= 1 && date->month <= 12 && is_valid_day(date->day, date->month, date->year);
+}
 
-    // flights.txt, passengers.txt -> backup_1
-    if (file_exists(flights_filename) && file_exists(passengers_filename))
+bool parse_batch_time(char *string, Time *time)
+{
+    // The whole string must be HH:MM
+    int length = 0;
+    if (sscanf(string, "%d:%d%n", &time->hours, &time->minutes, &length) != 2 || string[length] != '\0')
     {
-        if (rename(flights_filename, "backup_1_flights.txt") != 0)
-        {
-            printf(RED "Error moving flights.txt to backup_1_flights.txt" RESET);
-            return;
-        }
-        if (rename(passengers_filename, "backup_1_passengers.txt") != 0)
-        {
-            printf(RED "Error moving passengers.txt to backup_1_passengers.txt" RESET);
-            return;
-        }
+        return false;
     }
+    return time->hours >= 0 && time->hours <= 23 && time->minutes >= 0 && time->minutes <= 59;
 }
 
-bool file_exists(char *filename)
+bool parse_batch_int(char *string, int *value)
 {
-    // Check if the file exists
-    FILE *fp = fopen(filename, "r");
-    if (fp != NULL)
+    // The whole string must be a number that fits an int
+    long long number;
+    if (!parse_long_long(string, &number) || number < INT_MIN || number > INT_MAX)
     {
-        fclose(fp);
-        return true;
+        return false;
     }
-    return false;
-}
\ No newline at end of file
+    *value = (int)number;
+    return true;
+}
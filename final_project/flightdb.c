@@ -0,0 +1,4649 @@
+/*  Tabamo, Euan Jed S. - ST2L - June 2, 2024
+    Final Project - Flight Passenger Management System
+    Flight Database Library - the flights, passengers, and reservations behind the menus (see flightdb.h)
+*/
+
+#define _POSIX_C_SOURCE 200809L // read-write locks, truncate(), and fdatasync() are POSIX, so -std=c11 needs them asked for
+
+#include "flightdb.h"
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Library Constants/Definitions */
+
+#define INITIAL_BUFFER_SIZE 16 // the initial number of bytes allocated for a string
+#define MAX_BACKUPS 2          // the maximum number of backups allowed
+
+#define MANIFEST_FILE "MANIFEST"                        // the string representing the file that names the current save generation
+#define MANIFEST_TEMP_FILE "MANIFEST.tmp"               // the string representing the file a new manifest is written to before it is renamed
+#define GENERATION_FLIGHTS_FILE "flights.%ld.txt"       // the format of the flights file of a save generation
+#define GENERATION_PASSENGERS_FILE "passengers.%ld.txt" // the format of the passengers file of a save generation
+#define GENERATION_SNAPSHOT_FILE "snapshot.%ld.bin"     // the format of the binary snapshot of a save generation
+
+#define SNAPSHOT_MAGIC "FPMSNAP"          // the magic string at the start of a snapshot (7 characters + NUL)
+#define SNAPSHOT_VERSION 2                // the version of the snapshot format written by this program
+#define SNAPSHOT_BYTE_ORDER 0x01020304    // a marker that reads back differently on a machine with another byte order
+#define INITIAL_STRING_TABLE_SIZE 4096    // the initial number of bytes allocated for a snapshot's string table
+
+#define JOURNAL_TEMP_FILE "journal.txt.tmp" // the string representing the file a compacted journal is written to before it is renamed
+#define JOURNAL_COMPACT_SIZE (1024 * 1024) // the journal size in bytes after which it is compacted into a new save
+#define JOURNAL_OP_SIZE 32                 // the maximum array size of a journal operation name
+#define JOURNAL_MAX_FIELDS 7               // the maximum number of fields of a journal record
+#define JOURNAL_ADD_FLIGHT 0               // the journal operation for fdb_add_flight()
+#define JOURNAL_EDIT_FLIGHT 1              // the journal operation for fdb_edit_flight()
+#define JOURNAL_DELETE_FLIGHT 2            // the journal operation for fdb_delete_flight()
+#define JOURNAL_ADD_PASSENGER 3            // the journal operation for fdb_add_passenger()
+#define JOURNAL_EDIT_PASSENGER 4           // the journal operation for fdb_edit_passenger()
+#define JOURNAL_BOOK_RESERVATION 5         // the journal operation for fdb_book()
+#define JOURNAL_REMOVE_RESERVATION 6       // the journal operation for fdb_cancel()
+#define JOURNAL_OP_COUNT 7                 // the number of journal operations
+
+#define INDEX_INITIAL_CAPACITY 64 // the initial number of slots of a hash index (must be a power of two)
+#define INDEX_MAX_LOAD_PERCENT 70 // the maximum percentage of occupied slots before a hash index grows
+#define INITIAL_SCHEDULE_SIZE 4   // the initial number of entries allocated for a passenger's schedule
+#define INITIAL_AVAILABLE_SIZE 64 // the initial number of entries allocated for the availability index
+#define INITIAL_ROUTE_SIZE 4      // the initial number of entries allocated for the Flights of a route
+#define SKIP_LIST_MAX_LEVEL 16    // the maximum number of levels of the flight skip list (enough for 4^16 flights)
+
+#define ARENA_SLAB_SIZE (256 * 1024) // the number of bytes of each slab of the database arena
+#define ARENA_ALIGNMENT 16           // the number of bytes every arena block is rounded up to (keeps every block aligned)
+#define ARENA_FREE_CLASSES 32        // the number of block sizes with a free list (blocks up to 32 * 16 = 512 bytes are reused)
+
+#define STRINGIFY(x) #x           // turns a macro argument into a string
+#define TO_STRING(x) STRINGIFY(x) // turns the value of a macro into a string
+
+const char *MONTHS[12] = {"January", "February", "March", "April", // an array of month strings
+                          "May", "June", "July", "August",
+                          "September", "October", "November", "December"};
+
+const char *JOURNAL_OPS[JOURNAL_OP_COUNT] = {"ADD_FLIGHT", "EDIT_FLIGHT", "DELETE_FLIGHT", // the name of each journal operation
+                                            "ADD_PASSENGER", "EDIT_PASSENGER",
+                                            "BOOK_RESERVATION", "REMOVE_RESERVATION"};
+
+const int JOURNAL_OP_FIELDS[JOURNAL_OP_COUNT] = {7, 4, 1, 5, 3, 2, 3}; // the number of fields of each journal operation
+
+const int DAYS_IN_MONTH[2][13] = {{0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},  // the number of days of each month (common years)
+                                  {0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}}; // the number of days of each month (leap years)
+
+const char *STATUS_MESSAGES[FDB_STATUS_COUNT] = { // the message of each status code
+    "Success.",
+    "A valid Flight ID has at least 1 and at most 6 uppercase letters and/or digits only.",
+    "That Flight already exists.",
+    "That Flight does not exist.",
+    "Origin and destination cannot be empty.",
+    "Destination cannot be the same as the origin.",
+    "Departure must be after current date and time.",
+    "Duration is not in range (00:01 - 18:50).",
+    "The maximum number of passengers must be at least " TO_STRING(MIN_PASSENGERS_PER_FLIGHT) ".",
+    "You cannot decrease maximum passengers below number of reserved passengers.",
+    "The bonus miles must be at least 0.",
+    "That Flight is currently ongoing.",
+    "That Flight has already arrived.",
+    "That Flight has already departed.",
+    "That Flight is fully booked.",
+    "Passengers have already booked this Flight.",
+    "A valid passport number has 9 uppercase letters and/or digits.",
+    "Passenger with that passport number already exists.",
+    "That passenger does not exist.",
+    "First and last name cannot be empty.",
+    "Please enter a valid birth date. The maximum age is " TO_STRING(MAX_AGE) ".",
+    "The number of miles must be at least 0.",
+    "You already reserved this Flight.",
+    "That Flight conflicts with current reservations.",
+    "That reservation does not exist for that passenger.",
+    "You cannot remove an ongoing flight from your reservations.",
+    "Critical error. Flight missing from " FLIGHTS_FILE " file.",
+    "Error saving the files. The previous save is kept.",
+    "Error linking " FLIGHTS_FILE " and " PASSENGERS_FILE " to the new save.",
+    JOURNAL_FILE " is not a journal. It was not replayed.",
+    "Error opening or replacing " JOURNAL_FILE ". Changes will not be journaled.",
+    "No bookable flights connect the origin to the destination."};
+
+/* Structures */
+
+typedef struct ArenaSlab // A structure for one large block of memory handed out by an Arena.
+{
+    struct ArenaSlab *next; // A ptr to the previously allocated slab
+    size_t size;            // A size_t for the number of usable bytes in data
+    size_t used;            // A size_t for the number of bytes already handed out
+    max_align_t data[];     // The bytes handed out (max_align_t keeps the first block aligned)
+} ArenaSlab;
+
+typedef struct ArenaFreeBlock // A structure for a freed arena block waiting to be reused.
+{
+    struct ArenaFreeBlock *next; // A ptr to the next freed block of the same size
+} ArenaFreeBlock;
+
+typedef struct Arena // A region allocator: blocks come from large slabs and are all released together.
+{
+    struct ArenaSlab *slabs;                               // A ptr to the current slab (which links to the older ones)
+    struct ArenaFreeBlock *free_lists[ARENA_FREE_CLASSES]; // An array of freed blocks for each block size
+} Arena;
+
+typedef struct InternTable // An open-addressing hash table holding one shared copy of each distinct string.
+{
+    char **slots; // An array of strs (NULL means the slot is empty)
+    int capacity; // An int for the number of slots (always a power of two)
+    int count;    // An int for the number of strings in the table
+} InternTable;
+
+typedef struct FlightSkipList // A skip list over the Flights linked list, ordered by flight_compare().
+{
+    struct Flight *heads[SKIP_LIST_MAX_LEVEL]; // An array of ptrs to the first Flight node at each level (heads[0] is the head of the linked list)
+    int level;                                 // An int for the number of levels in use
+} FlightSkipList;
+
+typedef struct AvailabilityIndex // A structure for the bookable Flights (not departed, not full), ordered by flight_compare().
+{
+    struct Flight **flights;     // An array of ptrs to the bookable Flights (ordered by departure first)
+    int size;                    // An int for the number of Flights in the array
+    int capacity;                // An int for the number of Flights allocated
+    long long now;               // A long long for the time in minutes up to which departed Flights were dropped
+    struct ColumnWidths columns; // A ColumnWidths of the bookable Flights
+} AvailabilityIndex;
+
+typedef struct FlightTable // An open-addressing hash table indexing Flights by their flight_id.
+{
+    struct Flight **slots; // An array of ptrs to Flights (NULL means the slot is empty)
+    int capacity;          // An int for the number of slots (always a power of two)
+    int count;             // An int for the number of Flights in the table
+} FlightTable;
+
+typedef struct PassengerTable // An open-addressing hash table indexing Passengers by their passport_number.
+{
+    struct Passenger **slots; // An array of ptrs to Passengers (NULL means the slot is empty)
+    int capacity;             // An int for the number of slots (always a power of two)
+    int count;                // An int for the number of Passengers in the table
+} PassengerTable;
+
+typedef struct Route // A structure for the Flights from one origin to one destination, ordered by departure.
+{
+    char *origin;            // A str for the route's origin (interned, shared with its Flights)
+    char *destination;       // A str for the route's destination (interned, shared with its Flights)
+    struct Flight **flights; // An array of ptrs to the route's Flights (ordered by flight_compare(), so by departure)
+    int size;                // An int for the number of Flights in the array
+    int capacity;            // An int for the number of Flights allocated
+} Route;
+
+typedef struct RouteTable // An open-addressing hash table indexing Routes by their origin and destination.
+{
+    struct Route **slots; // An array of ptrs to Routes (NULL means the slot is empty)
+    int capacity;         // An int for the number of slots (always a power of two)
+    int count;            // An int for the number of Routes in the table (a Route stays after its last Flight is deleted)
+} RouteTable;
+
+typedef struct ItineraryStop // A structure for the earliest known arrival at an airport during an itinerary search.
+{
+    char *airport;      // A str for the airport (interned; NULL means the slot is empty)
+    long long arrival;  // A long long for the earliest arrival in minutes (the departure at the origin)
+    struct Flight *via; // A ptr to the Flight arriving then (NULL at the origin)
+    int legs;           // An int for the number of Flights taken to get there
+} ItineraryStop;
+
+typedef struct ItineraryStops // An open-addressing hash table of the ItineraryStops of one search (never grown: it has room for every airport).
+{
+    struct ItineraryStop *slots; // An array of ItineraryStops
+    int capacity;                // An int for the number of slots (always a power of two)
+} ItineraryStops;
+
+typedef struct SnapshotHeader // The fixed-width header at the start of a snapshot file.
+{
+    char magic[8];              // A str that must be SNAPSHOT_MAGIC
+    uint32_t version;           // A uint32 for the format version (SNAPSHOT_VERSION)
+    uint32_t byte_order;        // A uint32 that must read back as SNAPSHOT_BYTE_ORDER
+    uint32_t flight_count;      // A uint32 for the number of SnapshotFlights
+    uint32_t passenger_count;   // A uint32 for the number of SnapshotPassengers
+    uint32_t reservation_count; // A uint32 for the number of reservations (flight indices)
+    uint32_t string_table_size; // A uint32 for the number of bytes in the string table
+    uint64_t journal_sequence;  // A uint64 for the sequence number of the last journal record included in the snapshot
+} SnapshotHeader;
+
+typedef struct SnapshotFlight // A fixed-width Flight record of a snapshot (strings are string table offsets).
+{
+    uint32_t flight_id;    // A uint32 for the offset of the Flight's flight_id
+    uint32_t origin;       // A uint32 for the offset of the Flight's origin
+    uint32_t destination;  // A uint32 for the offset of the Flight's destination
+    int32_t departure[5];  // An array of int32 for the departure day, month, year, hours, and minutes
+    int32_t arrival[5];    // An array of int32 for the arrival day, month, year, hours, and minutes
+    int32_t passenger_qty; // An int32 for the Flight's current number of passengers
+    int32_t passenger_max; // An int32 for the Flight's maximum number of passengers allowed
+    int32_t bonus_miles;   // An int32 for the Flight's bonus miles
+} SnapshotFlight;
+
+typedef struct SnapshotPassenger // A fixed-width Passenger record of a snapshot (strings are string table offsets).
+{
+    uint32_t first_name;        // A uint32 for the offset of the Passenger's first name
+    uint32_t last_name;         // A uint32 for the offset of the Passenger's last name
+    uint32_t passport_number;   // A uint32 for the offset of the Passenger's passport number
+    int32_t birth_date[3];      // An array of int32 for the birth day, month, and year
+    int32_t miles;              // An int32 for the Passenger's miles
+    uint32_t reservation_start; // A uint32 for the index of the Passenger's first reservation
+    uint32_t reservation_qty;   // A uint32 for the Passenger's number of reservations
+} SnapshotPassenger;
+
+typedef struct SharedString // An interned string already written to a StringTable.
+{
+    char *string;    // A ptr to the interned string (NULL for an empty slot)
+    uint32_t offset; // A uint32 for the offset it was written at
+} SharedString;
+
+typedef struct StringTable // A growing buffer of NUL-terminated strings for writing a snapshot.
+{
+    char *data;                  // A str buffer holding every string one after another
+    uint32_t size;               // A uint32 for the number of bytes used
+    uint32_t capacity;           // A uint32 for the number of bytes allocated
+    struct SharedString *shared; // An open-addressing hash table of the interned strings written so far (never grown: it has room for every airport)
+    int shared_capacity;         // An int for the number of shared slots (always a power of two)
+} StringTable;
+
+typedef struct Journal // The append-only journal of changes made since the last save.
+{
+    FILE *fp;           // A ptr to the open journal file (NULL if it could not be opened)
+    long size;          // A long for the size of the journal file in bytes
+    long long sequence; // A long long for the sequence number of the last journal record
+    bool replaying;     // A boolean indicating if the journal is being replayed (so changes are not journaled again)
+    bool batching;      // A boolean indicating if a batch is running (so records are flushed once at the end instead of one by one)
+} Journal;
+
+struct FlightDB // A database: what used to be the program's globals, so several can be open at once.
+{
+    char directory[MAX_FILENAME_LENGTH]; // A str for the directory the files are kept in (empty or ending with a '/')
+    struct Flight *flights;              // A ptr to the first Flight of the Flights Linked List
+    struct Passenger *passengers;        // A ptr to the first Passenger of the Passengers Linked List
+    Arena arena;                         // An Arena of every Flight, Passenger, and Reservation node (and their strings)
+    FlightSkipList flight_order;         // A Flight Order Index
+    InternTable airport_table;           // An InternTable of Airport Names (origins and destinations)
+    FlightTable flight_table;            // A Flight ID Index
+    PassengerTable passenger_table;      // A Passport Number Index
+    int schedule_version;                // An int for the version of every Schedule (incremented when a booked Flight is edited)
+    AvailabilityIndex available_flights; // A Bookable Flights Index (with the column widths of the bookable Flights)
+    RouteTable route_table;              // A Route Index (the Flights of every origin and destination pair)
+    ColumnWidths flight_columns;         // A ColumnWidths of every Flight
+    long save_generation;                // A long for the number of the current save generation (0 if nothing was saved yet)
+    Journal journal;                     // A Journal of changes since the last save
+    DateTime current_datetime;           // A DateTime for when the clock was last read
+    long long current_minutes;           // A long long for the same DateTime in minutes (the clock snapshot every Flight Status is checked against)
+    pthread_rwlock_t lock;               // A read-write lock shared by bookings and cancellations (every other change takes it alone)
+    pthread_mutex_t arena_lock;          // A mutex for the arena while bookings and cancellations allocate and free Reservations
+    pthread_mutex_t availability_lock;   // A mutex for the availability index while bookings and cancellations fill and free seats
+    pthread_mutex_t journal_lock;        // A mutex held from journal_begin() to journal_end(), so records are never mixed
+};
+
+/* Comparison Helper Functions */
+
+int flight_item_compare(void *a, void *b);    // Compares two flights passed as generic items
+int passenger_item_compare(void *a, void *b); // Compares two passengers passed as generic items
+
+/* Arena Functions */
+
+void *arena_alloc(Arena *arena, size_t size);            // Allocates a block from an Arena (reusing a freed block of the same size if there is one)
+void arena_free(Arena *arena, void *block, size_t size); // Returns a block to its Arena's free list for its size
+char *arena_string(Arena *arena, char *string);          // Copies a string into an Arena
+void arena_free_string(Arena *arena, char *string);      // Returns a string copied by arena_string() to its Arena
+void free_arena(Arena *arena);                           // Frees every slab of an Arena at once
+
+/* Free Memory Functions */
+
+void free_flight_node(FlightDB *db, Flight *node);            // Frees memory allocated for a Flight node
+void free_passenger_node(FlightDB *db, Passenger *node);      // Frees memory allocated for a Passenger node
+void free_reservations_list(FlightDB *db, Reservation *head); // Frees all memory allocated for the reservations linked list
+void free_database(FlightDB *db);                             // Frees all memory allocated for the Flights, Passengers, and Reservations at once
+
+/* Flight Index Functions */
+
+unsigned int hash_string(char *string);                           // Hashes a string (FNV-1a)
+void flight_table_grow(FlightTable *table);                       // Doubles the number of slots of a FlightTable
+void flight_table_insert(FlightTable *table, Flight *flight);     // Inserts a Flight to a FlightTable (or replaces it if it is already there)
+Flight *flight_table_search(FlightTable *table, char *flight_id); // Searches for a Flight in a FlightTable and returns a pointer to it
+void flight_table_remove(FlightTable *table, Flight *flight);     // Removes a Flight from a FlightTable
+void free_flight_table(FlightTable *table);                       // Frees all memory allocated for a FlightTable
+
+/* Passenger Index Functions */
+
+void passenger_table_grow(PassengerTable *table);                                 // Doubles the number of slots of a PassengerTable
+void passenger_table_insert(PassengerTable *table, Passenger *passenger);         // Inserts a Passenger to a PassengerTable (or replaces it if it is already there)
+Passenger *passenger_table_search(PassengerTable *table, char *passport_number); // Searches for a Passenger in a PassengerTable and returns a pointer to it
+void passenger_table_remove(PassengerTable *table, Passenger *passenger);         // Removes a Passenger from a PassengerTable
+void free_passenger_table(PassengerTable *table);                                 // Frees all memory allocated for a PassengerTable
+
+/* String Interning Functions */
+
+void intern_table_grow(InternTable *table);            // Doubles the number of slots of an InternTable
+char *intern_string(InternTable *table, char *string); // Gets the shared copy of a string (adding it to an InternTable if it is new)
+char *intern_lookup(InternTable *table, char *string); // Gets the shared copy of a string (NULL if it is not in an InternTable)
+void free_intern_table(InternTable *table);            // Frees all memory allocated for an InternTable and its strings
+
+/* Flight Skip List Functions */
+
+int random_skip_level();                                                   // Gets a random number of levels for a new skip list node
+void skip_list_assign_levels(Arena *arena, Flight *node);                  // Gives a Flight node its skip list levels if it does not have them yet
+void skip_list_insert(FlightSkipList *list, Flight *node);                 // Inserts a Flight (with its levels) to a FlightSkipList (and the linked list) considering order
+void skip_list_append(FlightSkipList *list, Flight **tails, Flight *node); // Appends a Flight (with its levels) after every other Flight of a FlightSkipList (and the linked list)
+void skip_list_remove(FlightSkipList *list, Flight *node);                 // Removes a Flight from a FlightSkipList (and the linked list)
+
+/* Flight Linked List Functions */
+
+Flight *create_flight_node(FlightDB *db);                                                 // Creates a Flight node
+Flight *search_flight_node(FlightDB *db, char *flight_id);                                // Searches for a Flight in the flight index and returns a pointer to it
+void insert_flight_node(FlightDB *db, Flight *node);                                      // Insert a Flight to the linked list considering order
+void reinsert_flight_node(FlightDB *db, Flight *node);                                    // Reinserts a Flight to the linked list (ensures order of data is maintained after editing a node)
+void set_flight_times(FlightDB *db, Flight *flight, DateTime departure, DateTime arrival); // Changes the departure and arrival of a Flight (keeping its column widths and availability up to date)
+void delete_flight_node(FlightDB *db, Flight *node);                                      // Deletes a Flight from the linked list
+
+/* Passenger Linked List Functions */
+
+Passenger *create_passenger_node(FlightDB *db);                      // Creates a Passenger Node
+Passenger *search_passenger_node(FlightDB *db, char *passport_number); // Searches for a Passenger in the passenger index and returns a pointer to it
+void insert_passenger_node(FlightDB *db, Passenger *node);           // Insert a Passenger to the linked list considering order
+
+/* Bulk Load Functions */
+
+bool items_are_sorted(void **items, int count, int (*compare)(void *, void *)); // Checks if an array of items is already in order
+void sort_items(void **items, int count, int (*compare)(void *, void *));       // Sorts an array of items (stable merge sort)
+void link_flight_array(FlightDB *db, Flight **array, int count);                // Links a sorted array of Flights into the linked list and indexes in one pass
+void link_passenger_array(FlightDB *db, Passenger **array, int count);          // Links a sorted array of Passengers into the linked list and index in one pass
+
+/* Schedule Functions */
+
+void schedule_refresh(FlightDB *db, Schedule *schedule);                          // Recomputes a Schedule if a reserved Flight was edited since it was built
+void schedule_update_max_arrivals(Schedule *schedule, int start);                 // Recomputes the running latest arrivals of a Schedule from an index
+int schedule_lower_bound(Schedule *schedule, long long departure);                // Gets the index of the first entry departing at or after a time
+bool schedule_contains(FlightDB *db, Schedule *schedule, Flight *flight);         // Checks if a Flight is in a Schedule
+Flight *schedule_find_conflict(FlightDB *db, Schedule *schedule, Flight *flight); // Gets a reserved Flight that conflicts with a Flight (NULL if none)
+void schedule_insert(FlightDB *db, Schedule *schedule, Flight *flight);           // Inserts a Flight to a Schedule considering order
+void schedule_remove(FlightDB *db, Schedule *schedule, Flight *flight);           // Removes a Flight from a Schedule
+void free_schedule(Schedule *schedule);                                           // Frees all memory allocated for a Schedule
+
+/* Availability Index Functions */
+
+int availability_lower_bound(AvailabilityIndex *index, Flight *flight); // Gets the position of the first Flight not before a Flight in order
+void availability_insert(AvailabilityIndex *index, Flight *flight);     // Inserts a Flight to an AvailabilityIndex considering order
+void availability_remove(AvailabilityIndex *index, Flight *flight);     // Removes a Flight from an AvailabilityIndex (if it is there)
+void availability_update(AvailabilityIndex *index, Flight *flight);     // Adds or removes a Flight depending on whether it can still be booked
+void availability_advance(AvailabilityIndex *index, long long now);     // Drops every Flight that departed by a time in minutes
+Flight *availability_at(AvailabilityIndex *index, int position);        // Gets the Flight at a position of an AvailabilityIndex (NULL past the end)
+void free_availability_index(AvailabilityIndex *index);                 // Frees all memory allocated for an AvailabilityIndex
+
+/* Route Index Functions */
+
+unsigned int route_hash(char *origin, char *destination);                     // Hashes the addresses of an interned origin and destination together (the order matters)
+void route_table_grow(RouteTable *table);                                     // Doubles the number of slots of a RouteTable
+Route *route_table_search(RouteTable *table, char *origin, char *destination); // Searches for the Route of an interned origin and destination (NULL if there is none)
+Route *route_table_add(RouteTable *table, char *origin, char *destination);    // Gets the Route of an interned origin and destination, adding an empty one if it is new
+int route_lower_bound(Route *route, long long departure);                     // Gets the position of the first Flight of a Route departing at or after a time
+void route_insert(RouteTable *table, Flight *flight);                         // Inserts a Flight to its Route considering order
+void route_remove(RouteTable *table, Flight *flight);                         // Removes a Flight from its Route (before its departure changes)
+void free_route_table(RouteTable *table);                                     // Frees all memory allocated for a RouteTable and its Routes
+
+/* Itinerary Search Functions */
+
+int availability_first_departure(AvailabilityIndex *index, long long departure);           // Gets the position of the first bookable Flight departing at or after a time
+ItineraryStop *itinerary_stop(ItineraryStops *stops, char *airport, bool add);           // Gets the ItineraryStop of an interned airport (adding an unreached one if add is true, else NULL)
+bool itinerary_leg_allowed(FlightDB *db, Passenger *passenger, Flight *flight);          // Checks if a Flight has a free seat and does not conflict with a Passenger's reservations
+
+/* Column Width Functions */
+
+void column_widths_update(ColumnWidths *widths, Flight *flight, int change); // Adds (1) or removes (-1) the column lengths of a Flight
+int column_length(const char *string);                                       // Gets the length a string is counted as (clamped to the last count)
+
+/* Reservation Linked List Functions */
+
+Reservation *create_reservation_node(FlightDB *db, Passenger *passenger, Flight *flight); // Creates a Reservation Node (and adds it to the Flight's manifest)
+void insert_reservation_node(Reservation **head, Reservation *node);                      // Insert a Reservation to the linked list considering order
+void delete_reservation_node(FlightDB *db, Reservation **head, Flight *flight);           // Deletes a Reservation from the linked list
+void remove_reservation_node(FlightDB *db, Reservation **head, Reservation *node);        // Removes a known Reservation node from the linked list and frees it
+void unlink_manifest_node(Reservation *node);                                             // Removes a Reservation from its Flight's manifest
+
+/* File Functions */
+
+void database_path(FlightDB *db, char *path, const char *format, long generation);       // Gets the path of a file in the database's directory (the format may use the generation)
+void load_flights(FlightDB *db, FILE *fp);                                               // Load flights from a file
+bool load_passengers(FlightDB *db, FILE *fp);                                            // Load passengers from a file (false if a reserved Flight is missing)
+void save_flights(Flight *f_head, FILE *fp);                                             // Save flights to a file
+void save_passengers(Passenger *p_head, FILE *fp);                                       // Save passengers to a file
+int save(FlightDB *db);                                                                  // Save flights and passengers as a new save generation
+bool sync_and_close(FILE *fp);                                                           // Flushes a file to the disk and closes it (false if anything failed)
+void sync_directory(FlightDB *db);                                                       // Syncs the database's directory so its renamed and new files survive a crash
+bool save_text_file(char *filename, Flight *f_head, Passenger *p_head, bool is_flights); // Saves flights or passengers to a new text file and syncs it
+long read_manifest(FlightDB *db, long long *journal_sequence);                           // Gets the current save generation and its last journal record from the manifest (0 and -1 if there is none)
+bool publish_manifest(FlightDB *db, long generation, long long journal_sequence);        // Atomically makes a save generation the current one
+bool link_export_file(char *generation_filename, char *export_filename);                 // Points a text file name at a save generation's file (false if it failed)
+void remove_generation(FlightDB *db, long generation);                                   // Deletes the files of an old save generation
+
+/* Snapshot Functions */
+
+uint32_t string_table_add(StringTable *table, char *string);                                        // Adds a string to a StringTable and returns its offset
+uint32_t string_table_add_interned(StringTable *table, char *string);                               // Adds an interned string to a StringTable once and returns its offset (the same one every time)
+char *snapshot_string(FlightDB *db, const char *strings, uint32_t size, uint32_t offset);           // Copies a string out of a snapshot's string table into the database arena (NULL if the offset is invalid)
+bool save_snapshot(FlightDB *db, char *filename);                                                   // Saves flights and passengers to a binary snapshot
+bool load_snapshot(FlightDB *db, char *filename, long long *journal_sequence);                      // Loads flights and passengers from a binary snapshot (false if it is missing or invalid)
+bool snapshot_is_current(FlightDB *db, char *filename);                                             // Checks if a snapshot is at least as new as the text files
+
+/* Journal Functions */
+
+int journal_open(FlightDB *db, char *filename);                                             // Opens the journal for appending (creating it if needed)
+void journal_close(FlightDB *db);                                                           // Closes the journal
+void journal_begin(FlightDB *db, int op);                                                   // Starts a journal record
+void journal_end(FlightDB *db);                                                             // Ends a journal record and syncs it to the disk (unless a batch is running)
+void journal_sync(FlightDB *db);                                                            // Flushes the journal to the file and syncs it to the disk
+void journal_field(FlightDB *db, const char *format, ...);                                  // Writes one field of a journal record
+void journal_replay(FlightDB *db, char *filename, long long base_sequence, LoadReport *report); // Replays the journal records after a sequence number
+bool journal_apply(FlightDB *db, int op, char **fields);                                    // Applies one journal record (false if it does not fit the data)
+int journal_compact(FlightDB *db);                                                          // Saves everything and empties the journal
+
+/* Commit Functions (apply a change and journal it) */
+
+void commit_add_flight(FlightDB *db, Flight *flight);                                                 // Inserts a new Flight and journals it
+void commit_edit_flight(FlightDB *db, Flight *flight);                                                // Reorders an edited Flight and journals it
+void commit_delete_flight(FlightDB *db, Flight *flight);                                              // Removes a Flight's reservations, deletes it, and journals it
+void commit_add_passenger(FlightDB *db, Passenger *passenger);                                        // Inserts a new Passenger and journals it
+void commit_edit_passenger(FlightDB *db, Passenger *passenger);                                       // Journals an edited Passenger
+bool claim_seat(Flight *flight);                                                                       // Takes a seat of a Flight with a compare-and-swap (false if it is full)
+void commit_book_reservation(FlightDB *db, Passenger *passenger, Flight *flight);                     // Books a Flight for a Passenger (whose seat is claimed) and journals it
+void commit_remove_reservation(FlightDB *db, Passenger *passenger, Flight *flight, bool revoke_miles); // Removes a Passenger's reservation and journals it
+
+/* Change Functions (validate and commit a change, called with the database lock held alone) */
+
+int apply_add_flight(FlightDB *db, char *flight_id, char *origin, char *destination,                   // Adds a Flight
+                     DateTime departure, Time duration, int passenger_max, int bonus_miles);
+int apply_edit_flight(FlightDB *db, char *flight_id, DateTime departure, Time duration, int passenger_max); // Changes the departure, duration, and seats of a Flight
+int apply_delete_flight(FlightDB *db, char *flight_id);                                                    // Deletes a Flight (and the reservations of an arrived one)
+int apply_add_passenger(FlightDB *db, char *passport_number, char *first_name, char *last_name,        // Adds a Passenger
+                        Date birth_date, int miles);
+int apply_edit_passenger(FlightDB *db, char *passport_number, char *last_name, Date birth_date);           // Changes the last name and birth date of a Passenger
+
+/* Global Memory Handler */
+
+void (*memory_handler)() = NULL; // Global function called when memory runs out (shared by every database)
+
+void fdb_update_time(FlightDB *db)
+{
+    // Initialize a time_t variable with the current time and convert it to the local time (localtime_r() keeps databases on other threads apart)
+    time_t now = time(NULL);
+    struct tm local_time;
+    struct tm *time_now = localtime_r(&now, &local_time);
+
+    // Initialize a Date from the struct tm's year, month, and day
+    Date c_date = {
+        .year = (time_now->tm_year + 1900), // tm_year => years since 1900
+        .day = time_now->tm_mday,
+    };
+    c_date.month = time_now->tm_mon + 1; // tm_mon => months since January
+
+    // Initialize a Time from the struct tm's hours and minutes
+    Time c_time = {
+        .hours = time_now->tm_hour,
+        .minutes = time_now->tm_min,
+    };
+
+    // Set the current_datetime to the current date and time (with no change running)
+    pthread_rwlock_wrlock(&db->lock);
+    db->current_datetime = (DateTime){
+        .date = c_date,
+        .time = c_time,
+    };
+    db->current_minutes = datetime_to_minutes(db->current_datetime);
+
+    // Drop every Flight that departed since the clock was last read from the bookable Flights
+    availability_advance(&db->available_flights, db->current_minutes);
+    pthread_rwlock_unlock(&db->lock);
+}
+
+char *toupper_string(char *string)
+{
+    if (string != NULL)
+    {
+        for (int i = 0; string[i] != '\0'; i++)
+        {
+            if (islower(string[i]))
+            {
+                string[i] = toupper(string[i]); // Convert lowercase letters to uppercase
+            }
+        }
+    }
+    return string;
+}
+
+char *capitalize_string(char *string)
+{
+    if (string != NULL)
+    {
+        for (int i = 0; string[i] != '\0'; i++)
+        {
+            switch (i)
+            {
+            case 0: // Convert the first character to uppercase
+                string[i] = toupper(string[i]);
+                break;
+            default: // Convert all other characters to lowercase
+                if (string[i - 1] != ' ')
+                {
+                    string[i] = tolower(string[i]);
+                }
+                else
+                {
+                    string[i] = toupper(string[i]);
+                }
+                break;
+            }
+        }
+    }
+    return string;
+}
+
+FlightStatus retrieve_flight_status(Flight *flight, long long now)
+{
+    // Variable
+    FlightStatus status;
+
+    // The clock is read once per command (see fdb_update_time()), so this is only two integer compares
+
+    // Check if now is NOT in the future of the flight's departure (departure <= now)
+    status.flight_departed = flight->departure_minutes <= now;
+
+    // Check if now is in the future of the flight's arrival (arrival < now)
+    status.flight_arrived = flight->arrival_minutes < now;
+
+    return status;
+}
+
+void update_flight_minutes(Flight *flight)
+{
+    // Convert the departure and arrival DateTimes to minutes once so comparisons are plain integer compares
+    flight->departure_minutes = datetime_to_minutes(flight->departure);
+    flight->arrival_minutes = datetime_to_minutes(flight->arrival);
+}
+
+int flight_compare(Flight *a, Flight *b)
+{
+    // Sort by Departure (using the cached minutes)
+    if (a->departure_minutes != b->departure_minutes)
+    {
+        return (a->departure_minutes < b->departure_minutes) ? -1 : 1; // Return an integer indicating the order
+    }
+
+    // Sort by Origin (interned strings are equal exactly when their pointers are)
+    if (a->origin != b->origin)
+    {
+        return strcmp(a->origin, b->origin); // Return the result of strcmp()
+    }
+
+    // Sort by Destination
+    if (a->destination != b->destination)
+    {
+        return strcmp(a->destination, b->destination); // Return the result of strcmp()
+    }
+
+    // If all else fails, the flights are equal
+    return 0;
+}
+
+int passenger_compare(Passenger *a, Passenger *b)
+{
+    // Sort by First Names
+    int first_name_cmp = strcmp(a->first_name, b->first_name);
+    if (first_name_cmp != 0)
+    {
+        return first_name_cmp; // Return the result of strcmp()
+    }
+
+    // Sort by Last Names
+    int last_name_cmp = strcmp(a->last_name, b->last_name);
+    if (last_name_cmp != 0)
+    {
+        return last_name_cmp; // Return the result of strcmp()
+    }
+
+    // If all else fails, the passengers are equal
+    return 0;
+}
+
+int flight_item_compare(void *a, void *b)
+{
+    return flight_compare((Flight *)a, (Flight *)b); // Return the result of flight_compare()
+}
+
+int passenger_item_compare(void *a, void *b)
+{
+    return passenger_compare((Passenger *)a, (Passenger *)b); // Return the result of passenger_compare()
+}
+
+bool is_valid_day(int day, int month, int year)
+{
+    // Check if the day is in the range [1, number of days in the month]
+    return day >= 1 && day <= days_in_month(month, year);
+}
+
+bool is_valid_month(char *input)
+{
+    // Return true if input is in the MONTHS array
+    return month_to_int(input) != -1;
+}
+
+bool is_valid_nonempty_string(char *string)
+{
+    if (strlen(string) == 0)
+    {
+        return false; // Return false if the string is empty
+    }
+    return true; // Return true otherwise
+}
+
+bool is_valid_id(char *id)
+{
+    if (strlen(id) == 0)
+    {
+        return false; // Return false if the id is length 0 (no id)
+    }
+    if (strlen(id) > FLIGHT_ID_STR_LEN)
+    {
+        return false; // Return false if the id length exceeds the maximum length FLIGHT_ID_STR_LEN
+    }
+    for (int i = 0; id[i] != '\0'; i++)
+    {
+        if (!isalnum(id[i]))
+        {
+            return false; // Return false if the id contains non-alphanumeric characters
+        }
+    }
+    return true; // Return true otherwise
+}
+
+bool is_valid_passport(char *passport_number)
+{
+    if (strlen(passport_number) != PASSPORT_NUM_STR_LEN)
+    {
+        return false; // Return false if the passport number length is not equal to PASSPORT_NUM_STR_LEN
+    }
+    for (int i = 0; passport_number[i] != '\0'; i++)
+    {
+        if (!isalnum(passport_number[i]))
+        {
+            return false; // Return false if the passport number contains non-alphanumeric characters
+        }
+    }
+    return true; // Return true otherwise
+}
+
+int month_to_int(char *month)
+{
+    for (int i = 0; i < 12; i++)
+    {
+        // Check if the input matches any month in the array
+        if (strcmp(month, MONTHS[i]) == 0)
+        {
+            return i + 1; // Returns the month number of a month string
+        }
+    }
+    return -1; // Return -1 if the month is not found
+}
+
+const char *int_to_month(int month)
+{
+    // Return the month string of a month number (or an empty string if the number is not a month)
+    return (month >= 1 && month <= 12) ? MONTHS[month - 1] : "";
+}
+
+long long days_from_civil(int year, int month, int day)
+{
+    // Count years from March so that the leap day is the last day of a year
+    long long y = (month <= 2) ? year - 1 : year;
+
+    // Split the years into 400-year eras (every era has exactly 146097 days)
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long year_of_era = y - era * 400;                                          // [0, 399]
+    long long day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1; // [0, 365], from 1 March
+    long long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+
+    // Shift the epoch from 1 March 0000 to 1 January 1970
+    return era * 146097 + day_of_era - 719468;
+}
+
+Date civil_from_days(long long days)
+{
+    // Shift the epoch from 1 January 1970 to 1 March 0000 (the inverse of days_from_civil())
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    long long day_of_era = days - era * 146097;                                                          // [0, 146096]
+    long long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365; // [0, 399]
+    long long day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);         // [0, 365], from 1 March
+    long long month_from_march = (5 * day_of_year + 2) / 153;                                              // [0, 11]
+
+    Date date = {
+        .day = day_of_year - (153 * month_from_march + 2) / 5 + 1,
+        .month = month_from_march < 10 ? month_from_march + 3 : month_from_march - 9,
+        .year = year_of_era + era * 400,
+    };
+    if (date.month <= 2) // January and February belong to the next year
+    {
+        date.year++;
+    }
+    return date;
+}
+
+long long datetime_to_minutes(DateTime dt)
+{
+    // Convert the Date to days, then add the Time in minutes
+    return days_from_civil(dt.date.year, dt.date.month, dt.date.day) * 1440 +
+           dt.time.hours * 60 +
+           dt.time.minutes;
+}
+
+DateTime minutes_to_datetime(long long minutes)
+{
+    // Split the minutes into whole days and the minutes within the day (rounding down for dates before 1970)
+    long long days = (minutes >= 0 ? minutes : minutes - 1439) / 1440;
+    long long minute_of_day = minutes - days * 1440;
+
+    return (DateTime){
+        .date = civil_from_days(days),
+        .time = (Time){.hours = minute_of_day / 60, .minutes = minute_of_day % 60},
+    };
+}
+
+int days_in_month(int month, int year)
+{
+    // Look up the number of days in the table for common or leap years
+    return DAYS_IN_MONTH[is_leap(year)][month];
+}
+
+DateTime compute_arrival_datetime(DateTime departure, Time duration)
+{
+    // Add the duration to the departure in minutes, then convert back to a DateTime
+    return minutes_to_datetime(datetime_to_minutes(departure) + duration.hours * 60 + duration.minutes);
+}
+
+bool is_conflicting(DateTime departure1, DateTime arrival1, DateTime departure2, DateTime arrival2)
+{
+    // Convert DateTime to minutes
+    long long departure1_in_minutes = datetime_to_minutes(departure1);
+    long long arrival1_in_minutes = datetime_to_minutes(arrival1);
+    long long departure2_in_minutes = datetime_to_minutes(departure2);
+    long long arrival2_in_minutes = datetime_to_minutes(arrival2);
+
+    // Check if the DateTime is in the bounds of another DateTime
+    if ((departure1_in_minutes <= arrival2_in_minutes) && (arrival1_in_minutes >= departure2_in_minutes))
+    {
+        return true; // Return true if the DateTime is in the bounds of another DateTime
+    }
+    else
+    {
+        return false; // Return false otherwise
+    }
+}
+
+bool is_leap(int year)
+{
+    if (year % 4 != 0) // A leap year must be divisible by 4...
+    {
+        return false;
+    }
+    if (year % 100 != 0) // ...but must not be divisible by 100...
+    {
+        return true;
+    }
+    if (year % 400 == 0) // ...unless it is divisible by 400
+    {
+        return true;
+    }
+    return false;
+}
+
+bool is_future(DateTime date1, DateTime date2)
+{
+    // Check if the date2 DateTime is in the future compared to the date1 DateTime
+    return datetime_to_minutes(date2) > datetime_to_minutes(date1);
+}
+
+bool is_valid_birthdate(Date birth_date, DateTime now)
+{
+    // Check if the age of the person is less than or equal to MAX_AGE
+    return now.date.year - birth_date.year <= MAX_AGE;
+}
+
+bool is_valid_duration(Time duration)
+{
+    // Check if the duration in minutes is in range
+    int minutes = duration.hours * 60 + duration.minutes;
+    return minutes >= MIN_FLIGHT_DURATION_IN_MINUTES && minutes <= MAX_FLIGHT_DURATION_IN_MINUTES;
+}
+
+char *read_line(FILE *stream)
+{
+    // Variables
+    int buffer_length = INITIAL_BUFFER_SIZE, c, i = 0;
+    char *temp;
+
+    // Allocate memory for a string
+    char *buffer = (char *)malloc(sizeof(char) * buffer_length);
+    if (buffer == NULL) // If malloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    while ((c = fgetc(stream)) != '\n' && c != EOF) // Read characters from the file stream one by one
+    {
+        // Fill the buffer with the characters from the file stream
+        buffer[i++] = c;
+
+        // If we've reached the end of the buffer, reallocate more memory
+        if (i == buffer_length)
+        {
+            buffer_length *= 2;                                           // Increase size of buffer
+            temp = (char *)realloc(buffer, sizeof(char) * buffer_length); // Reallocate memory
+            if (temp == NULL)                                             // If realloc failed.
+            {
+                free(buffer);
+                fdb_out_of_memory();
+            }
+            else
+            {
+                buffer = temp; // Point the buffer to the new memory (if it ever moved)
+            }
+        }
+    }
+
+    // Null-terminate the string
+    buffer[i] = '\0';
+
+    // Shrink the buffer to the actual size
+    temp = (char *)realloc(buffer, sizeof(char) * (i + 1));
+    if (temp == NULL) // If realloc fails
+    {
+        free(buffer);
+        fdb_out_of_memory();
+    }
+    buffer = temp; // The buffer is resized to the optimal size
+
+    return buffer; // Return the string
+}
+
+void line_reader_init(LineReader *reader, FILE *fp)
+{
+    // Allocate the buffer
+    *reader = (LineReader){.fp = fp, .buffer = NULL, .capacity = LINE_READER_BUFFER_SIZE, .start = 0, .end = 0, .eof = false};
+    reader->buffer = (char *)malloc(sizeof(char) * reader->capacity);
+    if (reader->buffer == NULL) // If malloc failed
+    {
+        fdb_out_of_memory();
+    }
+}
+
+bool line_reader_next(LineReader *reader, StringView *line)
+{
+    while (true)
+    {
+        // If the rest of the block has a complete line, end it at its newline and return it
+        char *line_start = reader->buffer + reader->start;
+        char *newline = (char *)memchr(line_start, '\n', reader->end - reader->start);
+        if (newline != NULL)
+        {
+            *newline = '\0';
+            *line = (StringView){.data = line_start, .length = (size_t)(newline - line_start)};
+            reader->start += line->length + 1;
+            return true;
+        }
+
+        // At the end of the file, the rest is the last line (if there is one)
+        if (reader->eof)
+        {
+            if (reader->start == reader->end)
+            {
+                return false;
+            }
+            reader->buffer[reader->end] = '\0'; // There is always a byte left for this
+            *line = (StringView){.data = line_start, .length = reader->end - reader->start};
+            reader->start = reader->end;
+            return true;
+        }
+
+        // Move the incomplete line to the front of the buffer
+        memmove(reader->buffer, line_start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+
+        // If a single line fills the buffer, double the buffer
+        if (reader->end == reader->capacity - 1)
+        {
+            reader->capacity *= 2;
+            char *temp = (char *)realloc(reader->buffer, sizeof(char) * reader->capacity);
+            if (temp == NULL) // If realloc failed
+            {
+                free(reader->buffer);
+                fdb_out_of_memory();
+            }
+            reader->buffer = temp;
+        }
+
+        // Read the next block (keeping one byte to terminate the last line)
+        size_t bytes_read = fread(reader->buffer + reader->end, 1, reader->capacity - 1 - reader->end, reader->fp);
+        if (bytes_read == 0)
+        {
+            reader->eof = true;
+        }
+        reader->end += bytes_read;
+    }
+}
+
+StringView line_reader_field(LineReader *reader)
+{
+    // Variables
+    StringView line;
+
+    // A missing line reads as an empty one (like read_line() at the end of a file)
+    if (!line_reader_next(reader, &line))
+    {
+        line = (StringView){.data = "", .length = 0};
+    }
+
+    return line; // Return the line
+}
+
+char *string_view_copy(StringView view)
+{
+    // Allocate exactly enough memory for the string
+    char *string = (char *)malloc(sizeof(char) * (view.length + 1));
+    if (string == NULL) // If malloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    // Copy the string and its NUL terminator
+    memcpy(string, view.data, view.length + 1);
+
+    return string; // Return the copy
+}
+
+void free_line_reader(LineReader *reader)
+{
+    // Free the buffer
+    free(reader->buffer);
+    reader->buffer = NULL;
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+    // Round the size up so every block stays aligned
+    size = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+
+    // Reuse a freed block of the same size if there is one
+    size_t size_class = size / ARENA_ALIGNMENT - 1;
+    if (size_class < ARENA_FREE_CLASSES && arena->free_lists[size_class] != NULL)
+    {
+        ArenaFreeBlock *block = arena->free_lists[size_class];
+        arena->free_lists[size_class] = block->next;
+        return block;
+    }
+
+    // Start a new slab if the current one is full (an oversized block gets a slab of its own)
+    if (arena->slabs == NULL || arena->slabs->size - arena->slabs->used < size)
+    {
+        size_t slab_size = (size > ARENA_SLAB_SIZE) ? size : ARENA_SLAB_SIZE;
+        ArenaSlab *slab = (ArenaSlab *)malloc(sizeof(ArenaSlab) + slab_size);
+        if (slab == NULL) // If malloc failed
+        {
+            fdb_out_of_memory();
+        }
+        *slab = (ArenaSlab){.next = arena->slabs, .size = slab_size, .used = 0};
+        arena->slabs = slab;
+    }
+
+    // Hand out the next block of the current slab
+    void *block = (char *)arena->slabs->data + arena->slabs->used;
+    arena->slabs->used += size;
+
+    return block; // Return the block
+}
+
+void arena_free(Arena *arena, void *block, size_t size)
+{
+    // Only free the block if it is NOT NULL
+    if (block == NULL)
+    {
+        return;
+    }
+
+    // Push the block onto the free list for its size (larger blocks stay in their slab until free_arena())
+    size = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    size_t size_class = size / ARENA_ALIGNMENT - 1;
+    if (size_class < ARENA_FREE_CLASSES)
+    {
+        ArenaFreeBlock *free_block = (ArenaFreeBlock *)block;
+        free_block->next = arena->free_lists[size_class];
+        arena->free_lists[size_class] = free_block;
+    }
+}
+
+char *arena_string(Arena *arena, char *string)
+{
+    // Copy the string and its NUL terminator
+    size_t length = strlen(string) + 1;
+    char *copy = (char *)arena_alloc(arena, sizeof(char) * length);
+    memcpy(copy, string, length);
+
+    return copy; // Return the copy
+}
+
+void arena_free_string(Arena *arena, char *string)
+{
+    // The length of the string gives back the size it was allocated with
+    if (string != NULL)
+    {
+        arena_free(arena, string, sizeof(char) * (strlen(string) + 1));
+    }
+}
+
+void free_arena(Arena *arena)
+{
+    // Free every slab (and with them, every block ever handed out)
+    while (arena->slabs != NULL)
+    {
+        ArenaSlab *temp = arena->slabs;
+        arena->slabs = arena->slabs->next;
+        free(temp);
+    }
+    *arena = (Arena){.slabs = NULL, .free_lists = {NULL}};
+}
+
+void free_flight_node(FlightDB *db, Flight *node)
+{
+    // Only free the node if it is NOT NULL
+    if (node != NULL)
+    {
+        // Return strings in the node to the arena
+        arena_free_string(&db->arena, node->flight_id);
+        // The origin and destination are interned, so they are freed with airport_table
+        arena_free(&db->arena, node->skip_next, sizeof(Flight *) * node->skip_level);
+
+        // Return the node to the arena
+        arena_free(&db->arena, node, sizeof(Flight));
+    }
+}
+
+void free_passenger_node(FlightDB *db, Passenger *node)
+{
+    // Only free the node if it is NOT NULL
+    if (node != NULL)
+    {
+        // Remove the node from the passenger index (before its passport number is freed)
+        if (node->passport_number != NULL)
+        {
+            passenger_table_remove(&db->passenger_table, node);
+        }
+
+        // Return strings in the node to the arena
+        arena_free_string(&db->arena, node->first_name);
+        arena_free_string(&db->arena, node->last_name);
+        arena_free_string(&db->arena, node->passport_number);
+
+        // Free reservations
+        free_reservations_list(db, node->reservations);
+        free_schedule(&node->schedule);
+
+        // Return the node to the arena
+        arena_free(&db->arena, node, sizeof(Passenger));
+    }
+}
+
+void free_reservations_list(FlightDB *db, Reservation *head)
+{
+    // Return every node in the linked list to the arena (after removing it from its Flight's manifest)
+    while (head != NULL)
+    {
+        Reservation *temp = head;
+        head = head->next;
+        unlink_manifest_node(temp);
+        arena_free(&db->arena, temp, sizeof(Reservation));
+    }
+}
+
+void free_database(FlightDB *db)
+{
+    // A Passenger's schedule is the only part of a node not in the arena
+    for (Passenger *curr = db->passengers; curr != NULL; curr = curr->next)
+    {
+        free_schedule(&curr->schedule);
+    }
+
+    // Free every node and string at once (instead of one by one)
+    free_arena(&db->arena);
+    db->flights = NULL;
+    db->passengers = NULL;
+}
+
+unsigned int hash_string(char *string)
+{
+    // FNV-1a: XOR each byte into the hash, then multiply by the FNV prime
+    unsigned int hash = 2166136261u;
+    for (int i = 0; string[i] != '\0'; i++)
+    {
+        hash ^= (unsigned char)string[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void flight_table_grow(FlightTable *table)
+{
+    // Variables
+    Flight **old_slots = table->slots;
+    int old_capacity = table->capacity;
+    int new_capacity = (old_capacity == 0) ? INDEX_INITIAL_CAPACITY : old_capacity * 2;
+
+    // Allocate memory for the new (empty) slots
+    Flight **new_slots = (Flight **)calloc(new_capacity, sizeof(Flight *));
+    if (new_slots == NULL) // If calloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    table->slots = new_slots;
+    table->capacity = new_capacity;
+    table->count = 0;
+
+    // Rehash every Flight from the old slots into the new slots
+    for (int i = 0; i < old_capacity; i++)
+    {
+        if (old_slots[i] != NULL)
+        {
+            flight_table_insert(table, old_slots[i]);
+        }
+    }
+    free(old_slots);
+}
+
+void flight_table_insert(FlightTable *table, Flight *flight)
+{
+    // Grow the table before it gets too full (this also allocates the first slots)
+    if ((table->count + 1) * 100 > table->capacity * INDEX_MAX_LOAD_PERCENT)
+    {
+        flight_table_grow(table);
+    }
+
+    // Linear probing: start from the hashed slot and move forward until an empty slot or the same Flight ID
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = hash_string(flight->flight_id) & mask;
+    while (table->slots[i] != NULL)
+    {
+        if (strcmp(table->slots[i]->flight_id, flight->flight_id) == 0)
+        {
+            table->slots[i] = flight; // Replace the Flight if it is already indexed
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    table->slots[i] = flight;
+    table->count++;
+}
+
+Flight *flight_table_search(FlightTable *table, char *flight_id)
+{
+    // If the table is empty
+    if (table->count == 0)
+    {
+        return NULL;
+    }
+
+    // Probe from the hashed slot until an empty slot is found
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = hash_string(flight_id) & mask;
+    while (table->slots[i] != NULL)
+    {
+        if (strcmp(table->slots[i]->flight_id, flight_id) == 0)
+        {
+            return table->slots[i]; // Return the pointer to the Flight if found
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL; // Return NULL if not found
+}
+
+void flight_table_remove(FlightTable *table, Flight *flight)
+{
+    // If the table is empty
+    if (table->count == 0)
+    {
+        return;
+    }
+
+    // Find the slot of the Flight
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = hash_string(flight->flight_id) & mask;
+    while (table->slots[i] != flight)
+    {
+        if (table->slots[i] == NULL)
+        {
+            return; // The Flight is not in the table
+        }
+        i = (i + 1) & mask;
+    }
+    table->slots[i] = NULL;
+    table->count--;
+
+    // Backward shift deletion: move later Flights of the same probe run into the hole so searches never stop early
+    unsigned int hole = i;
+    unsigned int j = (i + 1) & mask;
+    while (table->slots[j] != NULL)
+    {
+        unsigned int home = hash_string(table->slots[j]->flight_id) & mask;
+
+        // Move the Flight if its home slot is not cyclically in (hole, j]
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            table->slots[hole] = table->slots[j];
+            table->slots[j] = NULL;
+            hole = j;
+        }
+        j = (j + 1) & mask;
+    }
+}
+
+void free_flight_table(FlightTable *table)
+{
+    // Free the slots (the Flights themselves are owned by the linked list)
+    free(table->slots);
+    *table = (FlightTable){.slots = NULL, .capacity = 0, .count = 0};
+}
+
+void passenger_table_grow(PassengerTable *table)
+{
+    // Variables
+    Passenger **old_slots = table->slots;
+    int old_capacity = table->capacity;
+    int new_capacity = (old_capacity == 0) ? INDEX_INITIAL_CAPACITY : old_capacity * 2;
+
+    // Allocate memory for the new (empty) slots
+    Passenger **new_slots = (Passenger **)calloc(new_capacity, sizeof(Passenger *));
+    if (new_slots == NULL) // If calloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    table->slots = new_slots;
+    table->capacity = new_capacity;
+    table->count = 0;
+
+    // Rehash every Passenger from the old slots into the new slots
+    for (int i = 0; i < old_capacity; i++)
+    {
+        if (old_slots[i] != NULL)
+        {
+            passenger_table_insert(table, old_slots[i]);
+        }
+    }
+    free(old_slots);
+}
+
+void passenger_table_insert(PassengerTable *table, Passenger *passenger)
+{
+    // Grow the table before it gets too full (this also allocates the first slots)
+    if ((table->count + 1) * 100 > table->capacity * INDEX_MAX_LOAD_PERCENT)
+    {
+        passenger_table_grow(table);
+    }
+
+    // Linear probing: start from the hashed slot and move forward until an empty slot or the same passport number
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = hash_string(passenger->passport_number) & mask;
+    while (table->slots[i] != NULL)
+    {
+        if (strcmp(table->slots[i]->passport_number, passenger->passport_number) == 0)
+        {
+            table->slots[i] = passenger; // Replace the Passenger if it is already indexed
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    table->slots[i] = passenger;
+    table->count++;
+}
+
+Passenger *passenger_table_search(PassengerTable *table, char *passport_number)
+{
+    // If the table is empty
+    if (table->count == 0)
+    {
+        return NULL;
+    }
+
+    // Probe from the hashed slot until an empty slot is found
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = hash_string(passport_number) & mask;
+    while (table->slots[i] != NULL)
+    {
+        if (strcmp(table->slots[i]->passport_number, passport_number) == 0)
+        {
+            return table->slots[i]; // Return the pointer to the Passenger if found
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL; // Return NULL if not found
+}
+
+void passenger_table_remove(PassengerTable *table, Passenger *passenger)
+{
+    // If the table is empty
+    if (table->count == 0)
+    {
+        return;
+    }
+
+    // Find the slot of the Passenger
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = hash_string(passenger->passport_number) & mask;
+    while (table->slots[i] != passenger)
+    {
+        if (table->slots[i] == NULL)
+        {
+            return; // The Passenger is not in the table
+        }
+        i = (i + 1) & mask;
+    }
+    table->slots[i] = NULL;
+    table->count--;
+
+    // Backward shift deletion (see flight_table_remove())
+    unsigned int hole = i;
+    unsigned int j = (i + 1) & mask;
+    while (table->slots[j] != NULL)
+    {
+        unsigned int home = hash_string(table->slots[j]->passport_number) & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            table->slots[hole] = table->slots[j];
+            table->slots[j] = NULL;
+            hole = j;
+        }
+        j = (j + 1) & mask;
+    }
+}
+
+void free_passenger_table(PassengerTable *table)
+{
+    // Free the slots (the Passengers themselves are owned by the linked list)
+    free(table->slots);
+    *table = (PassengerTable){.slots = NULL, .capacity = 0, .count = 0};
+}
+
+void intern_table_grow(InternTable *table)
+{
+    // Variables
+    char **old_slots = table->slots;
+    int old_capacity = table->capacity;
+    int new_capacity = (old_capacity == 0) ? INDEX_INITIAL_CAPACITY : old_capacity * 2;
+
+    // Allocate memory for the new (empty) slots
+    char **new_slots = (char **)calloc(new_capacity, sizeof(char *));
+    if (new_slots == NULL) // If calloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    // Rehash every string from the old slots into the new slots (the strings are distinct, so no comparisons are needed)
+    unsigned int mask = new_capacity - 1;
+    for (int i = 0; i < old_capacity; i++)
+    {
+        if (old_slots[i] != NULL)
+        {
+            unsigned int j = hash_string(old_slots[i]) & mask;
+            while (new_slots[j] != NULL)
+            {
+                j = (j + 1) & mask;
+            }
+            new_slots[j] = old_slots[i];
+        }
+    }
+    free(old_slots);
+
+    table->slots = new_slots;
+    table->capacity = new_capacity;
+}
+
+char *intern_string(InternTable *table, char *string)
+{
+    // Grow the table before it gets too full (this also allocates the first slots)
+    if ((table->count + 1) * 100 > table->capacity * INDEX_MAX_LOAD_PERCENT)
+    {
+        intern_table_grow(table);
+    }
+
+    // Linear probing: return the shared copy if the string is already in the table
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = hash_string(string) & mask;
+    while (table->slots[i] != NULL)
+    {
+        if (strcmp(table->slots[i], string) == 0)
+        {
+            return table->slots[i];
+        }
+        i = (i + 1) & mask;
+    }
+
+    // Otherwise, add a copy of the string to the empty slot
+    size_t length = strlen(string) + 1;
+    char *copy = (char *)malloc(sizeof(char) * length);
+    if (copy == NULL) // If malloc failed
+    {
+        fdb_out_of_memory();
+    }
+    memcpy(copy, string, length);
+    table->slots[i] = copy;
+    table->count++;
+
+    return copy; // Return the new shared copy
+}
+
+char *intern_lookup(InternTable *table, char *string)
+{
+    // An empty table has no slots yet
+    if (table->count == 0)
+    {
+        return NULL;
+    }
+
+    // Linear probing: check each occupied slot until an empty one is reached
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = hash_string(string) & mask;
+    while (table->slots[i] != NULL)
+    {
+        if (strcmp(table->slots[i], string) == 0)
+        {
+            return table->slots[i];
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+void free_intern_table(InternTable *table)
+{
+    // Free every string, then the slots
+    for (int i = 0; i < table->capacity; i++)
+    {
+        free(table->slots[i]);
+    }
+    free(table->slots);
+    *table = (InternTable){.slots = NULL, .capacity = 0, .count = 0};
+}
+
+int random_skip_level()
+{
+    // Every level has a 1 in 4 chance of also being part of the next level
+    int level = 1;
+    while (level < SKIP_LIST_MAX_LEVEL && rand() % 4 == 0)
+    {
+        level++;
+    }
+    return level;
+}
+
+void skip_list_assign_levels(Arena *arena, Flight *node)
+{
+    // Give the node its levels the first time it is inserted (a reinserted node keeps its levels)
+    if (node->skip_next == NULL)
+    {
+        node->skip_level = random_skip_level();
+        node->skip_next = (Flight **)arena_alloc(arena, sizeof(Flight *) * node->skip_level);
+    }
+}
+
+void skip_list_insert(FlightSkipList *list, Flight *node)
+{
+    // Variables
+    Flight *update[SKIP_LIST_MAX_LEVEL]; // The last node before the new node at each level (NULL means the heads)
+    Flight *curr = NULL;
+
+    // From the top level down, move forward while the next node is before or equal to the new node in order
+    for (int i = list->level - 1; i >= 0; i--)
+    {
+        Flight *next = (curr == NULL) ? list->heads[i] : curr->skip_next[i];
+        while (next != NULL && flight_compare(next, node) <= 0)
+        {
+            curr = next;
+            next = curr->skip_next[i];
+        }
+        update[i] = curr;
+    }
+
+    // Levels above the current top level start from the heads
+    for (int i = list->level; i < node->skip_level; i++)
+    {
+        update[i] = NULL;
+    }
+    if (node->skip_level > list->level)
+    {
+        list->level = node->skip_level;
+    }
+
+    // Link the node at each of its levels
+    for (int i = 0; i < node->skip_level; i++)
+    {
+        if (update[i] == NULL)
+        {
+            node->skip_next[i] = list->heads[i];
+            list->heads[i] = node;
+        }
+        else
+        {
+            node->skip_next[i] = update[i]->skip_next[i];
+            update[i]->skip_next[i] = node;
+        }
+    }
+
+    // Level 0 is the doubly linked list
+    node->prev = update[0];
+    node->next = node->skip_next[0];
+    if (node->prev != NULL)
+    {
+        node->prev->next = node;
+    }
+    if (node->next != NULL)
+    {
+        node->next->prev = node;
+    }
+}
+
+void skip_list_append(FlightSkipList *list, Flight **tails, Flight *node)
+{
+    // The caller keeps the last node at each level in tails (all NULL for an empty list) and gave the node its levels
+    if (node->skip_level > list->level)
+    {
+        list->level = node->skip_level;
+    }
+
+    // Link the node after the tail at each of its levels
+    for (int i = 0; i < node->skip_level; i++)
+    {
+        if (tails[i] == NULL)
+        {
+            list->heads[i] = node;
+        }
+        else
+        {
+            tails[i]->skip_next[i] = node;
+        }
+        node->skip_next[i] = NULL;
+    }
+
+    // Level 0 is the doubly linked list
+    node->prev = tails[0];
+    node->next = NULL;
+    if (node->prev != NULL)
+    {
+        node->prev->next = node;
+    }
+
+    // The node is now the tail of each of its levels
+    for (int i = 0; i < node->skip_level; i++)
+    {
+        tails[i] = node;
+    }
+}
+
+void skip_list_remove(FlightSkipList *list, Flight *node)
+{
+    // Variables
+    Flight *curr = node->prev;
+
+    // From the bottom level up, the node before it at each level is the closest earlier node that has that level
+    // (found through the prev ptrs, so this still works after an edit changed the node's place in the order)
+    for (int i = 0; i < node->skip_level; i++)
+    {
+        while (curr != NULL && curr->skip_level <= i)
+        {
+            curr = curr->prev;
+        }
+        if (curr == NULL)
+        {
+            list->heads[i] = node->skip_next[i];
+        }
+        else
+        {
+            curr->skip_next[i] = node->skip_next[i];
+        }
+    }
+
+    // Drop levels that became empty
+    while (list->level > 1 && list->heads[list->level - 1] == NULL)
+    {
+        list->level--;
+    }
+
+    // Level 0 is the doubly linked list
+    if (node->prev != NULL)
+    {
+        node->prev->next = node->next;
+    }
+    if (node->next != NULL)
+    {
+        node->next->prev = node->prev;
+    }
+    node->prev = NULL;
+    node->next = NULL;
+}
+
+Flight *create_flight_node(FlightDB *db)
+{
+    // Allocate memory for a new Flight node from the arena
+    Flight *new_flight = (Flight *)arena_alloc(&db->arena, sizeof(Flight));
+
+    // Set fields to defaults
+    *new_flight = (Flight){
+        .flight_id = NULL,
+        .destination = NULL,
+        .origin = NULL,
+        .departure.date = (Date){.day = 0, .month = 0, .year = 0},
+        .arrival.date = (Date){.day = 0, .month = 0, .year = 0},
+        .departure.time = (Time){.hours = 0, .minutes = 0},
+        .arrival.time = (Time){.hours = 0, .minutes = 0},
+        .departure_minutes = 0,
+        .arrival_minutes = 0,
+        .passenger_qty = 0,
+        .is_available = false,
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .bonus_miles = 0,
+        .index = 0,
+        .skip_level = 0,
+        .skip_next = NULL,
+        .prev = NULL,
+        .next = NULL};
+
+    return new_flight;
+}
+
+Flight *search_flight_node(FlightDB *db, char *flight_id)
+{
+    // Look up the Flight in the flight index
+    return flight_table_search(&db->flight_table, flight_id);
+}
+
+void insert_flight_node(FlightDB *db, Flight *node)
+{
+    // Index the Flight by its ID and by its route, and count its column widths
+    flight_table_insert(&db->flight_table, node);
+    route_insert(&db->route_table, node);
+    column_widths_update(&db->flight_columns, node, 1);
+
+    // Insert the Flight to the skip list, which also links it into the linked list in order
+    skip_list_assign_levels(&db->arena, node);
+    skip_list_insert(&db->flight_order, node);
+    db->flights = db->flight_order.heads[0];
+}
+
+void reinsert_flight_node(FlightDB *db, Flight *node)
+{
+    // Remove the node from its old position
+    skip_list_remove(&db->flight_order, node);
+
+    // Reinsert the node (the Flight ID does not change, so the flight index stays the same)
+    skip_list_insert(&db->flight_order, node);
+    db->flights = db->flight_order.heads[0];
+}
+
+void set_flight_times(FlightDB *db, Flight *flight, DateTime departure, DateTime arrival)
+{
+    // A Flight already in the linked list has its old column widths counted, and is in its route at its old departure
+    bool listed = search_flight_node(db, flight->flight_id) == flight;
+    if (listed)
+    {
+        column_widths_update(&db->flight_columns, flight, -1);
+        route_remove(&db->route_table, flight);
+    }
+
+    // The availability index is ordered by departure, so take the Flight out before its departure changes
+    availability_remove(&db->available_flights, flight);
+
+    // Change the times
+    flight->departure = departure;
+    flight->arrival = arrival;
+    update_flight_minutes(flight);
+
+    if (listed)
+    {
+        column_widths_update(&db->flight_columns, flight, 1);
+        route_insert(&db->route_table, flight);
+    }
+}
+
+void delete_flight_node(FlightDB *db, Flight *curr)
+{
+    // Remove the node from the flight and route indexes and its column widths
+    flight_table_remove(&db->flight_table, curr);
+    route_remove(&db->route_table, curr);
+    column_widths_update(&db->flight_columns, curr, -1);
+
+    // Remove the node from the skip list and the linked list
+    skip_list_remove(&db->flight_order, curr);
+    db->flights = db->flight_order.heads[0];
+
+    free_flight_node(db, curr); // Free the deleted node
+}
+
+int count_flights(Flight *head)
+{
+    int count = 0;
+
+    // Start from the head
+    Flight *ptr = head;
+
+    // Traverse the linked list, incrementing per node
+    while (ptr != NULL)
+    {
+        count++;
+        ptr = ptr->next;
+    }
+
+    return count; // Return the count
+}
+
+Passenger *create_passenger_node(FlightDB *db)
+{
+    // Allocate memory for a Passenger node from the arena
+    Passenger *new_passenger = (Passenger *)arena_alloc(&db->arena, sizeof(Passenger));
+
+    // Initialize fields to defaults
+    *new_passenger = (Passenger){
+        .first_name = NULL,
+        .last_name = NULL,
+        .birth_date = (Date){.day = 0, .month = 0, .year = 0},
+        .passport_number = NULL,
+        .reservation_qty = 0,
+        .miles = 0,
+        .reservations = NULL,
+        .schedule = (Schedule){.entries = NULL, .size = 0, .capacity = 0, .version = 0},
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .prev = NULL,
+        .next = NULL};
+
+    return new_passenger; // Return the Passenger
+}
+
+Passenger *search_passenger_node(FlightDB *db, char *passport_number)
+{
+    // Look up the Passenger in the passenger index
+    return passenger_table_search(&db->passenger_table, passport_number);
+}
+
+void insert_passenger_node(FlightDB *db, Passenger *node)
+{
+    // Start from the head
+    Passenger *curr = db->passengers;
+
+    // Index the Passenger by its passport number
+    passenger_table_insert(&db->passenger_table, node);
+
+    // If the list is empty OR the new node is before the head in order
+    if (db->passengers == NULL || passenger_compare(node, db->passengers) < 0)
+    {
+        node->next = db->passengers;
+        if (node->next != NULL)
+        {
+            node->next->prev = node;
+        }
+        db->passengers = node;
+    }
+    // Traverse the list until we find the correct position
+    else
+    {
+        while (curr->next != NULL && passenger_compare(node, curr->next) >= 0)
+        {
+            curr = curr->next;
+        }
+        node->next = curr->next;
+        if (node->next != NULL)
+        {
+            node->next->prev = node;
+        }
+        curr->next = node;
+        node->prev = curr;
+    }
+}
+
+int count_passengers(Passenger *head)
+{
+    int count = 0;
+
+    // Start from the head
+    Passenger *ptr = head;
+
+    // Traverse the linked list, incrementing per node
+    while (ptr != NULL)
+    {
+        count++;
+        ptr = ptr->next;
+    }
+
+    return count; // Return the count
+}
+
+bool items_are_sorted(void **items, int count, int (*compare)(void *, void *))
+{
+    // Every item must be after or equal to the one before it
+    for (int i = 1; i < count; i++)
+    {
+        if (compare(items[i - 1], items[i]) > 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void sort_items(void **items, int count, int (*compare)(void *, void *))
+{
+    // Allocate a buffer for merging
+    void **buffer = (void **)malloc(sizeof(void *) * count);
+    if (buffer == NULL) // If malloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    // Merge runs of width 1, 2, 4, ... (bottom-up merge sort keeps equal items in their original order)
+    for (int width = 1; width < count; width *= 2)
+    {
+        for (int left = 0; left < count; left += 2 * width)
+        {
+            int middle = (left + width < count) ? left + width : count;
+            int right = (left + 2 * width < count) ? left + 2 * width : count;
+            int i = left, j = middle, k = left;
+
+            // Take the smaller front item of the two runs (the left one on ties)
+            while (i < middle && j < right)
+            {
+                buffer[k++] = (compare(items[j], items[i]) < 0) ? items[j++] : items[i++];
+            }
+            while (i < middle)
+            {
+                buffer[k++] = items[i++];
+            }
+            while (j < right)
+            {
+                buffer[k++] = items[j++];
+            }
+        }
+
+        // Copy the merged runs back
+        memcpy(items, buffer, sizeof(void *) * count);
+    }
+
+    free(buffer);
+}
+
+void link_flight_array(FlightDB *db, Flight **array, int count)
+{
+    // Variables
+    Flight *tails[SKIP_LIST_MAX_LEVEL] = {NULL}; // The last node at each skip list level
+
+    // If there are already Flights, insert each one in order instead
+    if (db->flights != NULL)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            insert_flight_node(db, array[i]);
+            availability_update(&db->available_flights, array[i]);
+        }
+        return;
+    }
+
+    // Index each Flight and append it to the end of the skip list, the linked list, its route, and the availability index
+    for (int i = 0; i < count; i++)
+    {
+        flight_table_insert(&db->flight_table, array[i]);
+        route_insert(&db->route_table, array[i]);
+        column_widths_update(&db->flight_columns, array[i], 1);
+        skip_list_assign_levels(&db->arena, array[i]);
+        skip_list_append(&db->flight_order, tails, array[i]);
+        availability_update(&db->available_flights, array[i]);
+    }
+    db->flights = db->flight_order.heads[0];
+}
+
+void link_passenger_array(FlightDB *db, Passenger **array, int count)
+{
+    // If there are already Passengers, insert each one in order instead
+    if (db->passengers != NULL)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            insert_passenger_node(db, array[i]);
+        }
+        return;
+    }
+
+    // Index each Passenger and link it after the one before it
+    for (int i = 0; i < count; i++)
+    {
+        passenger_table_insert(&db->passenger_table, array[i]);
+        array[i]->prev = (i > 0) ? array[i - 1] : NULL;
+        array[i]->next = (i < count - 1) ? array[i + 1] : NULL;
+    }
+    if (count > 0)
+    {
+        db->passengers = array[0];
+    }
+}
+
+void schedule_refresh(FlightDB *db, Schedule *schedule)
+{
+    // Nothing to do if no booked Flight was edited since the Schedule was built
+    if (schedule->version == db->schedule_version)
+    {
+        return;
+    }
+
+    // Recompute the intervals of every entry
+    for (int i = 0; i < schedule->size; i++)
+    {
+        schedule->entries[i].departure = schedule->entries[i].flight->departure_minutes;
+        schedule->entries[i].arrival = schedule->entries[i].flight->arrival_minutes;
+    }
+
+    // Restore the order by departure (insertion sort, the entries are mostly sorted already)
+    for (int i = 1; i < schedule->size; i++)
+    {
+        ScheduleEntry entry = schedule->entries[i];
+        int j = i - 1;
+        while (j >= 0 && schedule->entries[j].departure > entry.departure)
+        {
+            schedule->entries[j + 1] = schedule->entries[j];
+            j--;
+        }
+        schedule->entries[j + 1] = entry;
+    }
+
+    schedule_update_max_arrivals(schedule, 0);
+    schedule->version = db->schedule_version;
+}
+
+void schedule_update_max_arrivals(Schedule *schedule, int start)
+{
+    for (int i = start; i < schedule->size; i++)
+    {
+        ScheduleEntry *entry = &schedule->entries[i];
+
+        // The latest arrival so far is either this entry's arrival or the latest arrival before it
+        if (i == 0 || entry->arrival > schedule->entries[i - 1].max_arrival)
+        {
+            entry->max_arrival = entry->arrival;
+            entry->max_arrival_index = i;
+        }
+        else
+        {
+            entry->max_arrival = schedule->entries[i - 1].max_arrival;
+            entry->max_arrival_index = schedule->entries[i - 1].max_arrival_index;
+        }
+    }
+}
+
+int schedule_lower_bound(Schedule *schedule, long long departure)
+{
+    // Binary search for the first entry with a departure >= the given departure
+    int low = 0, high = schedule->size;
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        if (schedule->entries[mid].departure < departure)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+bool schedule_contains(FlightDB *db, Schedule *schedule, Flight *flight)
+{
+    schedule_refresh(db, schedule);
+
+    // Check every entry with the same departure as the Flight
+    long long departure = flight->departure_minutes;
+    for (int i = schedule_lower_bound(schedule, departure); i < schedule->size && schedule->entries[i].departure == departure; i++)
+    {
+        if (schedule->entries[i].flight == flight)
+        {
+            return true; // Return true if the Flight is in the Schedule
+        }
+    }
+    return false; // Return false otherwise
+}
+
+Flight *schedule_find_conflict(FlightDB *db, Schedule *schedule, Flight *flight)
+{
+    schedule_refresh(db, schedule);
+
+    long long departure = flight->departure_minutes;
+    long long arrival = flight->arrival_minutes;
+
+    // Only the entries that depart at or before the Flight's arrival can conflict (the first `count` entries)
+    int count = schedule_lower_bound(schedule, arrival + 1);
+
+    // One of them conflicts if the latest arrival among them is at or after the Flight's departure
+    if (count > 0 && schedule->entries[count - 1].max_arrival >= departure)
+    {
+        return schedule->entries[schedule->entries[count - 1].max_arrival_index].flight; // Return the conflicting Flight
+    }
+    return NULL; // Return NULL if there are no conflicts
+}
+
+void schedule_insert(FlightDB *db, Schedule *schedule, Flight *flight)
+{
+    schedule_refresh(db, schedule);
+
+    // Grow the array if it is full
+    if (schedule->size == schedule->capacity)
+    {
+        int new_capacity = (schedule->capacity == 0) ? INITIAL_SCHEDULE_SIZE : schedule->capacity * 2;
+        ScheduleEntry *temp = (ScheduleEntry *)realloc(schedule->entries, sizeof(ScheduleEntry) * new_capacity);
+        if (temp == NULL) // If realloc failed
+        {
+            fdb_out_of_memory();
+        }
+        schedule->entries = temp;
+        schedule->capacity = new_capacity;
+    }
+
+    // Find the position of the Flight (after entries with the same departure) and shift the later entries
+    long long departure = flight->departure_minutes;
+    int position = schedule_lower_bound(schedule, departure + 1);
+    memmove(&schedule->entries[position + 1], &schedule->entries[position], sizeof(ScheduleEntry) * (schedule->size - position));
+
+    schedule->entries[position] = (ScheduleEntry){
+        .departure = departure,
+        .arrival = flight->arrival_minutes,
+        .flight = flight};
+    schedule->size++;
+
+    schedule_update_max_arrivals(schedule, position);
+}
+
+void schedule_remove(FlightDB *db, Schedule *schedule, Flight *flight)
+{
+    schedule_refresh(db, schedule);
+
+    // Find the entry of the Flight among the entries with the same departure
+    long long departure = flight->departure_minutes;
+    for (int i = schedule_lower_bound(schedule, departure); i < schedule->size && schedule->entries[i].departure == departure; i++)
+    {
+        if (schedule->entries[i].flight == flight)
+        {
+            // Shift the later entries over the removed entry
+            memmove(&schedule->entries[i], &schedule->entries[i + 1], sizeof(ScheduleEntry) * (schedule->size - i - 1));
+            schedule->size--;
+            schedule_update_max_arrivals(schedule, i);
+            return;
+        }
+    }
+}
+
+void free_schedule(Schedule *schedule)
+{
+    free(schedule->entries);
+    *schedule = (Schedule){.entries = NULL, .size = 0, .capacity = 0, .version = 0};
+}
+
+int availability_lower_bound(AvailabilityIndex *index, Flight *flight)
+{
+    // Binary search for the first Flight that is not before the given Flight in order
+    int low = 0, high = index->size;
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        if (flight_compare(index->flights[mid], flight) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void availability_insert(AvailabilityIndex *index, Flight *flight)
+{
+    // Grow the array if it is full
+    if (index->size == index->capacity)
+    {
+        int new_capacity = (index->capacity == 0) ? INITIAL_AVAILABLE_SIZE : index->capacity * 2;
+        Flight **temp = (Flight **)realloc(index->flights, sizeof(Flight *) * new_capacity);
+        if (temp == NULL) // If realloc failed
+        {
+            fdb_out_of_memory();
+        }
+        index->flights = temp;
+        index->capacity = new_capacity;
+    }
+
+    // Find the position of the Flight (after equal Flights, like the linked list) and shift the later Flights
+    int position = availability_lower_bound(index, flight);
+    while (position < index->size && flight_compare(index->flights[position], flight) == 0)
+    {
+        position++;
+    }
+    memmove(&index->flights[position + 1], &index->flights[position], sizeof(Flight *) * (index->size - position));
+
+    index->flights[position] = flight;
+    index->size++;
+    flight->is_available = true;
+    column_widths_update(&index->columns, flight, 1);
+}
+
+void availability_remove(AvailabilityIndex *index, Flight *flight)
+{
+    // Nothing to do if the Flight is not in the index
+    if (!flight->is_available)
+    {
+        return;
+    }
+
+    // Look for the Flight among the Flights equal to it (set_flight_times() removes a Flight before its departure changes)
+    int position = availability_lower_bound(index, flight);
+    while (index->flights[position] != flight)
+    {
+        position++;
+    }
+
+    // Shift the later Flights over the removed Flight
+    memmove(&index->flights[position], &index->flights[position + 1], sizeof(Flight *) * (index->size - position - 1));
+    index->size--;
+    flight->is_available = false;
+    column_widths_update(&index->columns, flight, -1);
+}
+
+void availability_update(AvailabilityIndex *index, Flight *flight)
+{
+    // A Flight can be booked if it has a free seat and has not departed
+    bool bookable = flight->passenger_qty < flight->passenger_max && flight->departure_minutes > index->now;
+
+    if (bookable && !flight->is_available)
+    {
+        availability_insert(index, flight);
+    }
+    else if (!bookable && flight->is_available)
+    {
+        availability_remove(index, flight);
+    }
+}
+
+void availability_advance(AvailabilityIndex *index, long long now)
+{
+    // The Flights are ordered by departure, so the departed ones are all at the front
+    int departed = 0;
+    while (departed < index->size && index->flights[departed]->departure_minutes <= now)
+    {
+        index->flights[departed]->is_available = false;
+        column_widths_update(&index->columns, index->flights[departed], -1);
+        departed++;
+    }
+
+    // Shift the remaining Flights to the front
+    if (departed > 0)
+    {
+        memmove(&index->flights[0], &index->flights[departed], sizeof(Flight *) * (index->size - departed));
+        index->size -= departed;
+    }
+    index->now = now;
+}
+
+Flight *availability_at(AvailabilityIndex *index, int position)
+{
+    return (position < index->size) ? index->flights[position] : NULL;
+}
+
+void free_availability_index(AvailabilityIndex *index)
+{
+    free(index->flights);
+    *index = (AvailabilityIndex){.flights = NULL, .size = 0, .capacity = 0, .now = index->now};
+}
+
+unsigned int route_hash(char *origin, char *destination)
+{
+    // Interned airports are equal exactly when their addresses are, so the addresses are hashed instead of the strings
+    // (the origin is multiplied before the destination is mixed in, so the route back has another hash)
+    uint64_t key = (uint64_t)(uintptr_t)origin * 0x9E3779B97F4A7C15ULL ^ (uint64_t)(uintptr_t)destination;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    return (unsigned int)(key >> 32);
+}
+
+void route_table_grow(RouteTable *table)
+{
+    // Variables
+    Route **old_slots = table->slots;
+    int old_capacity = table->capacity;
+    int new_capacity = (old_capacity == 0) ? INDEX_INITIAL_CAPACITY : old_capacity * 2;
+
+    // Allocate memory for the new (empty) slots
+    Route **new_slots = (Route **)calloc(new_capacity, sizeof(Route *));
+    if (new_slots == NULL) // If calloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    // Rehash every Route from the old slots into the new slots (the Routes are distinct, so no comparisons are needed)
+    unsigned int mask = new_capacity - 1;
+    for (int i = 0; i < old_capacity; i++)
+    {
+        if (old_slots[i] != NULL)
+        {
+            unsigned int j = route_hash(old_slots[i]->origin, old_slots[i]->destination) & mask;
+            while (new_slots[j] != NULL)
+            {
+                j = (j + 1) & mask;
+            }
+            new_slots[j] = old_slots[i];
+        }
+    }
+    free(old_slots);
+
+    table->slots = new_slots;
+    table->capacity = new_capacity;
+}
+
+Route *route_table_search(RouteTable *table, char *origin, char *destination)
+{
+    // An empty table has no slots yet
+    if (table->count == 0)
+    {
+        return NULL;
+    }
+
+    // Linear probing: check each occupied slot until an empty one is reached
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = route_hash(origin, destination) & mask;
+    while (table->slots[i] != NULL)
+    {
+        if (table->slots[i]->origin == origin && table->slots[i]->destination == destination)
+        {
+            return table->slots[i];
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+Route *route_table_add(RouteTable *table, char *origin, char *destination)
+{
+    // Grow the table before it gets too full (this also allocates the first slots)
+    if ((table->count + 1) * 100 > table->capacity * INDEX_MAX_LOAD_PERCENT)
+    {
+        route_table_grow(table);
+    }
+
+    // Linear probing: return the Route if it is already in the table
+    unsigned int mask = table->capacity - 1;
+    unsigned int i = route_hash(origin, destination) & mask;
+    while (table->slots[i] != NULL)
+    {
+        if (table->slots[i]->origin == origin && table->slots[i]->destination == destination)
+        {
+            return table->slots[i];
+        }
+        i = (i + 1) & mask;
+    }
+
+    // Otherwise, add an empty Route to the empty slot
+    Route *route = (Route *)malloc(sizeof(Route));
+    if (route == NULL) // If malloc failed
+    {
+        fdb_out_of_memory();
+    }
+    *route = (Route){.origin = origin, .destination = destination, .flights = NULL, .size = 0, .capacity = 0};
+    table->slots[i] = route;
+    table->count++;
+
+    return route;
+}
+
+int route_lower_bound(Route *route, long long departure)
+{
+    // Binary search for the first Flight that does not depart before the time
+    int low = 0, high = route->size;
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        if (route->flights[mid]->departure_minutes < departure)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void route_insert(RouteTable *table, Flight *flight)
+{
+    // Variables
+    Route *route = route_table_add(table, flight->origin, flight->destination);
+
+    // Grow the array if it is full
+    if (route->size == route->capacity)
+    {
+        int new_capacity = (route->capacity == 0) ? INITIAL_ROUTE_SIZE : route->capacity * 2;
+        Flight **temp = (Flight **)realloc(route->flights, sizeof(Flight *) * new_capacity);
+        if (temp == NULL) // If realloc failed
+        {
+            fdb_out_of_memory();
+        }
+        route->flights = temp;
+        route->capacity = new_capacity;
+    }
+
+    // Insert after the Flights departing at the same time, like the linked list (loading appends, so nothing is shifted)
+    int position = route_lower_bound(route, flight->departure_minutes + 1);
+    memmove(&route->flights[position + 1], &route->flights[position], sizeof(Flight *) * (route->size - position));
+    route->flights[position] = flight;
+    route->size++;
+}
+
+void route_remove(RouteTable *table, Flight *flight)
+{
+    // Variables
+    Route *route = route_table_search(table, flight->origin, flight->destination);
+    if (route == NULL)
+    {
+        return;
+    }
+
+    // Look for the Flight among the Flights departing at the same time
+    int position = route_lower_bound(route, flight->departure_minutes);
+    while (position < route->size && route->flights[position] != flight)
+    {
+        position++;
+    }
+    if (position == route->size)
+    {
+        return;
+    }
+
+    // Shift the later Flights over the removed Flight
+    memmove(&route->flights[position], &route->flights[position + 1], sizeof(Flight *) * (route->size - position - 1));
+    route->size--;
+}
+
+void free_route_table(RouteTable *table)
+{
+    // Free every Route's array and the Route itself (the Flights are owned by the linked list), then the slots
+    for (int i = 0; i < table->capacity; i++)
+    {
+        if (table->slots[i] != NULL)
+        {
+            free(table->slots[i]->flights);
+            free(table->slots[i]);
+        }
+    }
+    free(table->slots);
+    *table = (RouteTable){.slots = NULL, .capacity = 0, .count = 0};
+}
+
+int availability_first_departure(AvailabilityIndex *index, long long departure)
+{
+    // Binary search for the first Flight that does not depart before the time (the index is ordered by departure first)
+    int low = 0, high = index->size;
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        if (index->flights[mid]->departure_minutes < departure)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+ItineraryStop *itinerary_stop(ItineraryStops *stops, char *airport, bool add)
+{
+    // Linear probing on the airport's address, hashed like a route without a destination (interned airports are equal exactly when their pointers are)
+    unsigned int mask = stops->capacity - 1;
+    unsigned int i = route_hash(airport, NULL) & mask;
+    while (stops->slots[i].airport != NULL)
+    {
+        if (stops->slots[i].airport == airport)
+        {
+            return &stops->slots[i];
+        }
+        i = (i + 1) & mask;
+    }
+    if (!add)
+    {
+        return NULL;
+    }
+
+    // The table has room for every airport, so an empty slot is always found
+    stops->slots[i] = (ItineraryStop){.airport = airport, .arrival = LLONG_MAX, .via = NULL, .legs = 0};
+    return &stops->slots[i];
+}
+
+bool itinerary_leg_allowed(FlightDB *db, Passenger *passenger, Flight *flight)
+{
+    // The seat rule of claim_seat() (the index only holds bookable Flights, but a booking on another thread can fill one)
+    if (flight->passenger_qty >= flight->passenger_max)
+    {
+        return false;
+    }
+
+    if (passenger == NULL)
+    {
+        return true;
+    }
+
+    // The conflict check of fdb_book() (a reserved Flight conflicts with itself), with the Passenger's lock held like there,
+    // since the check rebuilds the Passenger's Schedule if a reserved Flight was edited
+    pthread_mutex_lock(&passenger->lock);
+    bool allowed = schedule_find_conflict(db, &passenger->schedule, flight) == NULL;
+    pthread_mutex_unlock(&passenger->lock);
+    return allowed;
+}
+
+void column_widths_update(ColumnWidths *widths, Flight *flight, int change)
+{
+    widths->origin[column_length(flight->origin)] += change;
+    widths->destination[column_length(flight->destination)] += change;
+    widths->departure_month[column_length(int_to_month(flight->departure.date.month))] += change;
+    widths->arrival_month[column_length(int_to_month(flight->arrival.date.month))] += change;
+}
+
+int column_length(const char *string)
+{
+    // Strings at least as long as the last count share it (the listing only lines up to that length)
+    size_t length = strlen(string);
+    return (length < COLUMN_WIDTH_LIMIT) ? (int)length : COLUMN_WIDTH_LIMIT - 1;
+}
+
+int column_width(const int *counts)
+{
+    // The width is the longest length that some Flight still has
+    int width = COLUMN_WIDTH_LIMIT - 1;
+    while (width > 0 && counts[width] == 0)
+    {
+        width--;
+    }
+    return width;
+}
+
+Reservation *create_reservation_node(FlightDB *db, Passenger *passenger, Flight *flight)
+{
+    // Allocate memory for a Reservation node from the arena (bookings on other threads share it)
+    pthread_mutex_lock(&db->arena_lock);
+    Reservation *new_reservation = (Reservation *)arena_alloc(&db->arena, sizeof(Reservation));
+    pthread_mutex_unlock(&db->arena_lock);
+
+    // Initialize fields with the Passenger and the Flight
+    *new_reservation = (Reservation){
+        .flight = flight, .passenger = passenger, .prev = NULL, .next = NULL, .manifest_prev = NULL, .manifest_next = NULL};
+
+    // Add the Reservation to the front of the Flight's manifest (other Passengers may be booking the same Flight)
+    pthread_mutex_lock(&flight->lock);
+    new_reservation->manifest_next = flight->manifest;
+    if (flight->manifest != NULL)
+    {
+        flight->manifest->manifest_prev = new_reservation;
+    }
+    flight->manifest = new_reservation;
+    pthread_mutex_unlock(&flight->lock);
+
+    return new_reservation; // Return the Reservation
+}
+
+Reservation *search_reservation_node(Reservation *head, Flight *flight)
+{
+    // Start from the head
+    Reservation *curr = head;
+
+    // Traverse the linked list
+    while (curr != NULL)
+    {
+        if (strcmp(curr->flight->flight_id, flight->flight_id) == 0)
+        {
+            return curr; // Return the pointer to the node
+        }
+        curr = curr->next;
+    }
+    return NULL; // Return NULL if node does not exist
+}
+
+void insert_reservation_node(Reservation **head, Reservation *node)
+{
+    // Start from the head
+    Reservation *curr = *head;
+
+    // If the list is empty OR the new node is before the *head in order
+    if (*head == NULL || flight_compare(node->flight, (*head)->flight) < 0)
+    {
+        node->next = *head;
+        if (node->next != NULL)
+        {
+            node->next->prev = node;
+        }
+        *head = node;
+    }
+    // Traverse the list until we find the correct position
+    else
+    {
+        while (curr->next != NULL && flight_compare(node->flight, (*head)->flight) >= 0)
+        {
+            curr = curr->next;
+        }
+        node->next = curr->next;
+        if (node->next != NULL)
+        {
+            node->next->prev = node;
+        }
+        curr->next = node;
+        node->prev = curr;
+    }
+}
+
+void delete_reservation_node(FlightDB *db, Reservation **head, Flight *flight)
+{
+    // Start from the head
+    Reservation *curr = *head;
+
+    // Find the node to delete
+    while (curr != NULL && curr->flight != flight)
+    {
+        curr = curr->next;
+    }
+
+    // If the node was not found (the caller checks this first)
+    if (curr == NULL)
+    {
+        return;
+    }
+
+    // Remove the node from the linked list (and the Flight's manifest)
+    remove_reservation_node(db, &(*head), curr);
+}
+
+void remove_reservation_node(FlightDB *db, Reservation **head, Reservation *node)
+{
+    // Remove the node from the linked list
+    if (node->prev != NULL)
+    {
+        node->prev->next = node->next;
+    }
+    else // If the node to remove is the head
+    {
+        *head = node->next;
+    }
+    if (node->next != NULL)
+    {
+        node->next->prev = node->prev;
+    }
+
+    // Remove the node from the Flight's manifest
+    unlink_manifest_node(node);
+
+    // Return the removed node to the arena
+    pthread_mutex_lock(&db->arena_lock);
+    arena_free(&db->arena, node, sizeof(Reservation));
+    pthread_mutex_unlock(&db->arena_lock);
+}
+
+void unlink_manifest_node(Reservation *node)
+{
+    // Remove the node from the Flight's manifest (other Passengers may be booking the same Flight)
+    Flight *flight = node->flight;
+    pthread_mutex_lock(&flight->lock);
+    if (node->manifest_prev != NULL)
+    {
+        node->manifest_prev->manifest_next = node->manifest_next;
+    }
+    else // If the node is the first in the manifest
+    {
+        node->flight->manifest = node->manifest_next;
+    }
+    if (node->manifest_next != NULL)
+    {
+        node->manifest_next->manifest_prev = node->manifest_prev;
+    }
+    node->manifest_prev = node->manifest_next = NULL;
+    pthread_mutex_unlock(&flight->lock);
+}
+
+int count_reservations(Reservation *head)
+{
+    int count = 0;
+
+    // Start from the head
+    Reservation *ptr = head;
+
+    // Traverse the list, incrementing per node
+    while (ptr != NULL)
+    {
+        count++;
+        ptr = ptr->next;
+    }
+
+    return count; // Return the count
+}
+
+void database_path(FlightDB *db, char *path, const char *format, long generation)
+{
+    // Put the directory in front (fdb_create() keeps it short enough), then fill in the generation (formats without one ignore it)
+    size_t length = strlen(db->directory);
+    memcpy(path, db->directory, length);
+    snprintf(path + length, MAX_FILENAME_LENGTH - length, format, generation);
+}
+
+void load_flights(FlightDB *db, FILE *fp)
+{
+    // Variables
+    int flight_count = 0;
+    int loaded_count = 0;
+    char month[MONTH_STR_SIZE];
+    Flight **loaded = NULL;
+    LineReader reader;
+    StringView line;
+
+    line_reader_init(&reader, fp);
+    flight_count = atoi(line_reader_field(&reader).data); // Read the flight count
+    if (flight_count > 0)                                 // If there are flights
+    {
+        // Allocate an array for the flights (the count in the file is only a hint)
+        int capacity = flight_count;
+        loaded = (Flight **)malloc(sizeof(Flight *) * capacity);
+        if (loaded == NULL) // If malloc failed
+        {
+            fdb_out_of_memory();
+        }
+
+        while (line_reader_next(&reader, &line)) // While there are flights to read
+        {
+            // Skip blank lines between records
+            if (line.length == 0)
+            {
+                continue;
+            }
+
+            // Grow the array if it is full
+            if (loaded_count == capacity)
+            {
+                capacity *= 2;
+                Flight **grown = (Flight **)realloc(loaded, sizeof(Flight *) * capacity);
+                if (grown == NULL) // If realloc failed
+                {
+                    free(loaded);
+                    fdb_out_of_memory();
+                }
+                loaded = grown;
+            }
+
+            // Create a Flight node
+            Flight *f_temp = create_flight_node(db);
+
+            // Scan each field from the file (only the strings are copied)
+            f_temp->flight_id = arena_string(&db->arena, (char *)line.data);
+            f_temp->origin = intern_string(&db->airport_table, (char *)line_reader_field(&reader).data);
+            f_temp->destination = intern_string(&db->airport_table, (char *)line_reader_field(&reader).data);
+            sscanf(line_reader_field(&reader).data, "%d %9s %d - %d:%d",
+                   &f_temp->departure.date.day, month, &f_temp->departure.date.year,
+                   &f_temp->departure.time.hours, &f_temp->departure.time.minutes);
+            f_temp->departure.date.month = month_to_int(month);
+            sscanf(line_reader_field(&reader).data, "%d %9s %d - %d:%d",
+                   &f_temp->arrival.date.day, month, &f_temp->arrival.date.year,
+                   &f_temp->arrival.time.hours, &f_temp->arrival.time.minutes);
+            f_temp->arrival.date.month = month_to_int(month);
+            f_temp->passenger_qty = atoi(line_reader_field(&reader).data);
+            f_temp->passenger_max = atoi(line_reader_field(&reader).data);
+            f_temp->bonus_miles = atoi(line_reader_field(&reader).data);
+            update_flight_minutes(f_temp);
+
+            // Add the Flight to the array
+            loaded[loaded_count++] = f_temp;
+        }
+
+        // Saved files are already in order, so only sort if the file was edited
+        if (!items_are_sorted((void **)loaded, loaded_count, flight_item_compare))
+        {
+            sort_items((void **)loaded, loaded_count, flight_item_compare);
+        }
+
+        // Link the Flights to the Linked List in one pass
+        link_flight_array(db, loaded, loaded_count);
+        free(loaded);
+    }
+
+    free_line_reader(&reader);
+}
+
+bool load_passengers(FlightDB *db, FILE *fp)
+{
+    // Variables
+    int passenger_count = 0;
+    int loaded_count = 0;
+    int capacity = 0;
+    char month[MONTH_STR_SIZE];
+    Flight *reserved_flight;
+    Reservation *r_ptr;
+    Passenger **loaded = NULL;
+    LineReader reader;
+    StringView line;
+
+    line_reader_init(&reader, fp);
+    passenger_count = atoi(line_reader_field(&reader).data); // Read the passenger count
+    if (passenger_count <= 0)                                // If there are no passengers
+    {
+        free_line_reader(&reader);
+        return true;
+    }
+
+    // Allocate an array for the passengers (the count in the file is only a hint)
+    capacity = passenger_count;
+    loaded = (Passenger **)malloc(sizeof(Passenger *) * capacity);
+    if (loaded == NULL) // If malloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    while (line_reader_next(&reader, &line)) // While there are passengers to read
+    {
+        // Skip blank lines between records
+        if (line.length == 0)
+        {
+            continue;
+        }
+
+        // Grow the array if it is full
+        if (loaded_count == capacity)
+        {
+            capacity *= 2;
+            Passenger **grown = (Passenger **)realloc(loaded, sizeof(Passenger *) * capacity);
+            if (grown == NULL) // If realloc failed
+            {
+                free(loaded);
+                fdb_out_of_memory();
+            }
+            loaded = grown;
+        }
+
+        // Create a Passenger node
+        Passenger *p_temp = create_passenger_node(db);
+
+        // Scan each field from the file (only the strings are copied)
+        p_temp->last_name = arena_string(&db->arena, (char *)line.data);
+        p_temp->first_name = arena_string(&db->arena, (char *)line_reader_field(&reader).data);
+        p_temp->passport_number = arena_string(&db->arena, (char *)line_reader_field(&reader).data);
+        sscanf(line_reader_field(&reader).data, "%d %9s %d",
+               &p_temp->birth_date.day,
+               month,
+               &p_temp->birth_date.year);
+        p_temp->birth_date.month = month_to_int(month);
+        p_temp->reservation_qty = atoi(line_reader_field(&reader).data);
+
+        // Read the reservations
+        for (int i = 0; i < p_temp->reservation_qty; i++)
+        {
+            // Search for the flight (the Flight ID is looked up in place, without copying it)
+            reserved_flight = search_flight_node(db, (char *)line_reader_field(&reader).data);
+            if (reserved_flight == NULL)
+            {
+                free_passenger_node(db, p_temp);
+                link_passenger_array(db, loaded, loaded_count); // Link the loaded Passengers so fdb_close() frees them
+                free(loaded);
+                free_line_reader(&reader);
+                return false;
+            }
+
+            // Create a Reservation node (which also adds it to the Flight's manifest)
+            r_ptr = create_reservation_node(db, p_temp, reserved_flight);
+
+            // Insert the Reservation node to the passenger's reservations linked list and schedule
+            insert_reservation_node(&p_temp->reservations, r_ptr);
+            schedule_insert(db, &p_temp->schedule, reserved_flight);
+        }
+        p_temp->miles = atoi(line_reader_field(&reader).data);
+
+        // Add the Passenger to the array
+        loaded[loaded_count++] = p_temp;
+    }
+
+    // Saved files are already in order, so only sort if the file was edited
+    if (!items_are_sorted((void **)loaded, loaded_count, passenger_item_compare))
+    {
+        sort_items((void **)loaded, loaded_count, passenger_item_compare);
+    }
+
+    // Link the Passengers to the Linked List in one pass
+    link_passenger_array(db, loaded, loaded_count);
+    free(loaded);
+    free_line_reader(&reader);
+    return true;
+}
+
+int fdb_load(FlightDB *db, LoadReport *report)
+{
+    // Variables
+    long long journal_sequence = -1;  // The last journal record in the loaded data (-1 means the journal knows)
+    long long manifest_sequence = -1; // The last journal record in the current save generation (-1 if the manifest does not say)
+    char filename[MAX_FILENAME_LENGTH];
+    int status;
+
+    *report = (LoadReport){.replayed = 0, .skipped = 0, .journal_status = FDB_OK};
+
+    // Find the current save generation
+    db->save_generation = read_manifest(db, &manifest_sequence);
+    database_path(db, filename, GENERATION_SNAPSHOT_FILE, db->save_generation);
+
+    // Load the generation's binary snapshot unless the text files were edited after it was saved
+    if (db->save_generation == 0 || !snapshot_is_current(db, filename) ||
+        !load_snapshot(db, filename, &journal_sequence))
+    {
+        // The text files hold the same journal records as the snapshot (the journal's header can be older if a crash
+        // came between the save and swapping in the empty journal)
+        journal_sequence = manifest_sequence;
+
+        // Load Flights
+        database_path(db, filename, FLIGHTS_FILE, 0);
+        FILE *fp = fopen(filename, "r");
+        if (fp != NULL) // If the file exists
+        {
+            load_flights(db, fp);
+            fclose(fp);
+        }
+
+        // Load Passengers
+        database_path(db, filename, PASSENGERS_FILE, 0);
+        fp = fopen(filename, "r");
+        if (fp != NULL) // If both files exist
+        {
+            bool complete = load_passengers(db, fp);
+            fclose(fp);
+            if (!complete) // If a reserved Flight is missing, nothing can be trusted
+            {
+                return FDB_MISSING_FLIGHT;
+            }
+        }
+    }
+
+    // Replay the changes made after the last save, then keep journaling new ones
+    database_path(db, filename, JOURNAL_FILE, 0);
+    journal_replay(db, filename, journal_sequence, report);
+    status = journal_open(db, filename);
+    if (report->journal_status == FDB_OK)
+    {
+        report->journal_status = status;
+    }
+
+    return FDB_OK;
+}
+
+void save_flights(Flight *f_head, FILE *fp)
+{
+    // Variables
+    int flight_count = count_flights(f_head);
+    Flight *f_ptr = f_head;
+
+    // Write the Flight count
+    fprintf(fp, "%d\n", flight_count);
+
+    // Print each Flight detail to the file
+    while (f_ptr != NULL)
+    {
+        fprintf(fp, "%s\n", f_ptr->flight_id);
+        fprintf(fp, "%s\n", f_ptr->origin);
+        fprintf(fp, "%s\n", f_ptr->destination);
+        fprintf(fp, "%d %s %d - %02d:%02d\n",
+                f_ptr->departure.date.day, int_to_month(f_ptr->departure.date.month), f_ptr->departure.date.year,
+                f_ptr->departure.time.hours, f_ptr->departure.time.minutes);
+        fprintf(fp, "%d %s %d - %02d:%02d\n",
+                f_ptr->arrival.date.day, int_to_month(f_ptr->arrival.date.month), f_ptr->arrival.date.year,
+                f_ptr->arrival.time.hours, f_ptr->arrival.time.minutes);
+        fprintf(fp, "%d\n", f_ptr->passenger_qty);
+        fprintf(fp, "%d\n", f_ptr->passenger_max);
+        fprintf(fp, "%d\n", f_ptr->bonus_miles);
+
+        f_ptr = f_ptr->next;
+    }
+}
+
+void save_passengers(Passenger *p_head, FILE *fp)
+{
+    // Variables
+    int passenger_count = count_passengers(p_head);
+    Passenger *p_ptr = p_head;
+    Reservation *r_ptr = NULL;
+
+    // Write the Passenger count
+    fprintf(fp, "%d\n", passenger_count);
+
+    // Write each Passenger detail to the file
+    while (p_ptr != NULL)
+    {
+        fprintf(fp, "%s\n", p_ptr->last_name);
+        fprintf(fp, "%s\n", p_ptr->first_name);
+        fprintf(fp, "%s\n", p_ptr->passport_number);
+        fprintf(fp, "%d %s %d\n",
+                p_ptr->birth_date.day, int_to_month(p_ptr->birth_date.month), p_ptr->birth_date.year);
+        fprintf(fp, "%d\n", p_ptr->reservation_qty);
+        r_ptr = p_ptr->reservations;
+        for (int i = 0; i < p_ptr->reservation_qty; i++)
+        {
+            fprintf(fp, "%s\n", r_ptr->flight->flight_id);
+            r_ptr = r_ptr->next;
+        }
+        fprintf(fp, "%d\n", p_ptr->miles);
+
+        p_ptr = p_ptr->next;
+    }
+}
+
+int save(FlightDB *db)
+{
+    // Variables
+    long generation = db->save_generation + 1;
+    char flights_filename[MAX_FILENAME_LENGTH], passengers_filename[MAX_FILENAME_LENGTH], snapshot_filename[MAX_FILENAME_LENGTH];
+
+    char export_filename[MAX_FILENAME_LENGTH];
+    bool exported;
+
+    database_path(db, flights_filename, GENERATION_FLIGHTS_FILE, generation);
+    database_path(db, passengers_filename, GENERATION_PASSENGERS_FILE, generation);
+    database_path(db, snapshot_filename, GENERATION_SNAPSHOT_FILE, generation);
+
+    // Write the new generation's files (nothing reads them until the manifest names them)
+    if (!save_text_file(flights_filename, db->flights, db->passengers, true) ||
+        !save_text_file(passengers_filename, db->flights, db->passengers, false) ||
+        !save_snapshot(db, snapshot_filename))
+    {
+        remove_generation(db, generation);
+        return FDB_SAVE_FAILED;
+    }
+
+    // Publish the new generation with a single rename
+    if (!publish_manifest(db, generation, db->journal.sequence))
+    {
+        remove_generation(db, generation);
+        return FDB_SAVE_FAILED;
+    }
+    db->save_generation = generation;
+
+    // Point flights.txt and passengers.txt at the new generation (for viewing and editing them by hand)
+    database_path(db, export_filename, FLIGHTS_FILE, 0);
+    exported = link_export_file(flights_filename, export_filename);
+    database_path(db, export_filename, PASSENGERS_FILE, 0);
+    exported = link_export_file(passengers_filename, export_filename) && exported;
+
+    // Keep the previous generations as backups and delete older ones
+    if (generation > MAX_BACKUPS + 1)
+    {
+        remove_generation(db, generation - MAX_BACKUPS - 1);
+    }
+
+    return exported ? FDB_OK : FDB_EXPORT_FAILED;
+}
+
+bool sync_and_close(FILE *fp)
+{
+    // Flush the stdio buffer, then the kernel's
+    bool success = fflush(fp) == 0 && fdatasync(fileno(fp)) == 0;
+    return (fclose(fp) == 0) && success;
+}
+
+void sync_directory(FlightDB *db)
+{
+    // A rename or a new file is only kept once the directory holding it is synced
+    int dir_fd = open((db->directory[0] == '\0') ? "." : db->directory, O_RDONLY);
+    if (dir_fd != -1)
+    {
+        fsync(dir_fd);
+        close(dir_fd);
+    }
+}
+
+bool save_text_file(char *filename, Flight *f_head, Passenger *p_head, bool is_flights)
+{
+    // Create the file
+    FILE *fp = fopen(filename, "w");
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    // Write the flights or the passengers
+    if (is_flights)
+    {
+        save_flights(f_head, fp);
+    }
+    else
+    {
+        save_passengers(p_head, fp);
+    }
+
+    // Make sure it reached the disk
+    return !ferror(fp) && sync_and_close(fp);
+}
+
+long read_manifest(FlightDB *db, long long *journal_sequence)
+{
+    // Variables
+    long generation = 0;
+    char filename[MAX_FILENAME_LENGTH];
+
+    *journal_sequence = -1;
+
+    // Read the generation number and the last journal record it includes (a manifest without it leaves the journal's header to say)
+    database_path(db, filename, MANIFEST_FILE, 0);
+    FILE *fp = fopen(filename, "r");
+    if (fp != NULL)
+    {
+        int fields = fscanf(fp, "MANIFEST %ld %lld", &generation, journal_sequence);
+        if (fields < 1 || generation < 0)
+        {
+            generation = 0;
+        }
+        if (fields < 2 || generation == 0 || *journal_sequence < 0)
+        {
+            *journal_sequence = -1;
+        }
+        fclose(fp);
+    }
+
+    return generation;
+}
+
+bool publish_manifest(FlightDB *db, long generation, long long journal_sequence)
+{
+    // Variables
+    char temp_filename[MAX_FILENAME_LENGTH], filename[MAX_FILENAME_LENGTH];
+
+    // Write the new manifest to a temporary file
+    database_path(db, temp_filename, MANIFEST_TEMP_FILE, 0);
+    database_path(db, filename, MANIFEST_FILE, 0);
+    FILE *fp = fopen(temp_filename, "w");
+    if (fp == NULL)
+    {
+        return false;
+    }
+    fprintf(fp, "MANIFEST %ld %lld\n", generation, journal_sequence);
+    if (!sync_and_close(fp))
+    {
+        return false;
+    }
+
+    // Replace the old manifest (rename is atomic, so readers see the old or the new generation, never a mix)
+    if (rename(temp_filename, filename) != 0)
+    {
+        return false;
+    }
+
+    // Sync the directory so the rename itself survives a crash
+    sync_directory(db);
+
+    return true;
+}
+
+bool link_export_file(char *generation_filename, char *export_filename)
+{
+    // Variables
+    char temp_filename[MAX_FILENAME_LENGTH];
+
+    // Hard link the generation's file to a temporary name, then rename it over the old one (no data is copied)
+    snprintf(temp_filename, MAX_FILENAME_LENGTH, "%s.tmp", export_filename);
+    unlink(temp_filename);
+    if (link(generation_filename, temp_filename) != 0 || rename(temp_filename, export_filename) != 0)
+    {
+        unlink(temp_filename);
+        return false;
+    }
+
+    return true;
+}
+
+void remove_generation(FlightDB *db, long generation)
+{
+    // Variables
+    char filename[MAX_FILENAME_LENGTH];
+
+    // Delete each file of the generation (missing files are fine)
+    database_path(db, filename, GENERATION_FLIGHTS_FILE, generation);
+    unlink(filename);
+    database_path(db, filename, GENERATION_PASSENGERS_FILE, generation);
+    unlink(filename);
+    database_path(db, filename, GENERATION_SNAPSHOT_FILE, generation);
+    unlink(filename);
+}
+
+uint32_t string_table_add(StringTable *table, char *string)
+{
+    // Variables
+    uint32_t offset = table->size;
+    uint32_t length = (uint32_t)strlen(string) + 1;
+
+    // Grow the buffer if the string does not fit
+    if (table->size + length > table->capacity)
+    {
+        uint32_t capacity = (table->capacity == 0) ? INITIAL_STRING_TABLE_SIZE : table->capacity;
+        while (table->size + length > capacity)
+        {
+            capacity *= 2;
+        }
+        char *grown = (char *)realloc(table->data, capacity);
+        if (grown == NULL) // If realloc failed
+        {
+            free(table->data);
+            fdb_out_of_memory();
+        }
+        table->data = grown;
+        table->capacity = capacity;
+    }
+
+    // Copy the string (with its NUL terminator) to the end of the buffer
+    memcpy(table->data + table->size, string, length);
+    table->size += length;
+
+    return offset; // Return where the string starts
+}
+
+uint32_t string_table_add_interned(StringTable *table, char *string)
+{
+    // Linear probing on the string's hash (interned strings are equal exactly when their pointers are, so slots compare pointers)
+    unsigned int mask = table->shared_capacity - 1;
+    unsigned int i = hash_string(string) & mask;
+    while (table->shared[i].string != NULL)
+    {
+        if (table->shared[i].string == string)
+        {
+            return table->shared[i].offset; // Return where it was already written
+        }
+        i = (i + 1) & mask;
+    }
+
+    // The table has room for every interned string, so an empty slot is always found
+    table->shared[i] = (SharedString){.string = string, .offset = string_table_add(table, string)};
+    return table->shared[i].offset;
+}
+
+char *snapshot_string(FlightDB *db, const char *strings, uint32_t size, uint32_t offset)
+{
+    // The offset must point inside the string table (which always ends with a NUL terminator)
+    if (offset >= size)
+    {
+        return NULL;
+    }
+
+    // Copy the string into the database arena (the snapshot is unmapped after loading)
+    return arena_string(&db->arena, (char *)strings + offset); // Return the copy
+}
+
+bool save_snapshot(FlightDB *db, char *filename)
+{
+    // Variables
+    SnapshotHeader header = {.magic = SNAPSHOT_MAGIC, .version = SNAPSHOT_VERSION, .byte_order = SNAPSHOT_BYTE_ORDER};
+    StringTable strings = {.data = NULL, .size = 0, .capacity = 0, .shared = NULL, .shared_capacity = INDEX_INITIAL_CAPACITY};
+    SnapshotFlight *flight_records = NULL;
+    SnapshotPassenger *passenger_records = NULL;
+    uint32_t *reservation_records = NULL;
+    bool success = false;
+
+    // Count the records
+    header.flight_count = (uint32_t)count_flights(db->flights);
+    header.passenger_count = (uint32_t)count_passengers(db->passengers);
+    for (Passenger *p_ptr = db->passengers; p_ptr != NULL; p_ptr = p_ptr->next)
+    {
+        header.reservation_count += (uint32_t)p_ptr->reservation_qty;
+    }
+
+    // Allocate the record arrays (one extra element so an empty dataset never allocates 0 bytes)
+    flight_records = (SnapshotFlight *)malloc(sizeof(SnapshotFlight) * (header.flight_count + 1));
+    passenger_records = (SnapshotPassenger *)malloc(sizeof(SnapshotPassenger) * (header.passenger_count + 1));
+    reservation_records = (uint32_t *)malloc(sizeof(uint32_t) * (header.reservation_count + 1));
+    if (flight_records == NULL || passenger_records == NULL || reservation_records == NULL) // If malloc failed
+    {
+        free(flight_records);
+        free(passenger_records);
+        free(reservation_records);
+        fdb_out_of_memory();
+    }
+
+    // Allocate at least twice as many shared strings as there are airports (each airport is written once)
+    while (strings.shared_capacity < db->airport_table.count * 2)
+    {
+        strings.shared_capacity *= 2;
+    }
+    strings.shared = (SharedString *)calloc(strings.shared_capacity, sizeof(SharedString));
+    if (strings.shared == NULL) // If calloc failed
+    {
+        free(flight_records);
+        free(passenger_records);
+        free(reservation_records);
+        fdb_out_of_memory();
+    }
+
+    // Fill the Flight records (and remember each Flight's index for the reservations)
+    uint32_t i = 0;
+    for (Flight *f_ptr = db->flights; f_ptr != NULL; f_ptr = f_ptr->next, i++)
+    {
+        f_ptr->index = (int)i;
+        flight_records[i] = (SnapshotFlight){
+            .flight_id = string_table_add(&strings, f_ptr->flight_id),
+            .origin = string_table_add_interned(&strings, f_ptr->origin),
+            .destination = string_table_add_interned(&strings, f_ptr->destination),
+            .departure = {f_ptr->departure.date.day, f_ptr->departure.date.month, f_ptr->departure.date.year,
+                          f_ptr->departure.time.hours, f_ptr->departure.time.minutes},
+            .arrival = {f_ptr->arrival.date.day, f_ptr->arrival.date.month, f_ptr->arrival.date.year,
+                        f_ptr->arrival.time.hours, f_ptr->arrival.time.minutes},
+            .passenger_qty = f_ptr->passenger_qty,
+            .passenger_max = f_ptr->passenger_max,
+            .bonus_miles = f_ptr->bonus_miles};
+    }
+
+    // Fill the Passenger records and their reservations (as Flight indices)
+    uint32_t r = 0;
+    i = 0;
+    for (Passenger *p_ptr = db->passengers; p_ptr != NULL; p_ptr = p_ptr->next, i++)
+    {
+        passenger_records[i] = (SnapshotPassenger){
+            .first_name = string_table_add(&strings, p_ptr->first_name),
+            .last_name = string_table_add(&strings, p_ptr->last_name),
+            .passport_number = string_table_add(&strings, p_ptr->passport_number),
+            .birth_date = {p_ptr->birth_date.day, p_ptr->birth_date.month, p_ptr->birth_date.year},
+            .miles = p_ptr->miles,
+            .reservation_start = r,
+            .reservation_qty = (uint32_t)p_ptr->reservation_qty};
+        for (Reservation *r_ptr = p_ptr->reservations; r_ptr != NULL; r_ptr = r_ptr->next)
+        {
+            reservation_records[r++] = (uint32_t)r_ptr->flight->index;
+        }
+    }
+    header.string_table_size = strings.size;
+    header.journal_sequence = (uint64_t)db->journal.sequence;
+
+    // Write every section one after another
+    FILE *fp = fopen(filename, "wb");
+    if (fp != NULL)
+    {
+        success = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+                  fwrite(flight_records, sizeof(SnapshotFlight), header.flight_count, fp) == header.flight_count &&
+                  fwrite(passenger_records, sizeof(SnapshotPassenger), header.passenger_count, fp) == header.passenger_count &&
+                  fwrite(reservation_records, sizeof(uint32_t), header.reservation_count, fp) == header.reservation_count &&
+                  fwrite(strings.data, 1, strings.size, fp) == strings.size;
+        success = sync_and_close(fp) && success;
+    }
+
+    // Free the buffers
+    free(flight_records);
+    free(passenger_records);
+    free(reservation_records);
+    free(strings.data);
+    free(strings.shared);
+
+    return success;
+}
+
+bool load_snapshot(FlightDB *db, char *filename, long long *journal_sequence)
+{
+    // Variables
+    struct stat file_stat;
+    SnapshotHeader header;
+
+    // Open the file and get its size
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) // If the file does not exist
+    {
+        return false;
+    }
+    if (fstat(fd, &file_stat) != 0 || (size_t)file_stat.st_size < sizeof(SnapshotHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    // Map the whole file into memory
+    size_t file_size = (size_t)file_stat.st_size;
+    const char *data = (const char *)mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after closing
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // Check the header and that every section fits in the file
+    memcpy(&header, data, sizeof(header));
+    size_t expected_size = sizeof(SnapshotHeader) +
+                           sizeof(SnapshotFlight) * (size_t)header.flight_count +
+                           sizeof(SnapshotPassenger) * (size_t)header.passenger_count +
+                           sizeof(uint32_t) * (size_t)header.reservation_count +
+                           (size_t)header.string_table_size;
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header.version != SNAPSHOT_VERSION || header.byte_order != SNAPSHOT_BYTE_ORDER ||
+        expected_size != file_size ||
+        (header.string_table_size > 0 && data[file_size - 1] != '\0'))
+    {
+        munmap((void *)data, file_size);
+        return false;
+    }
+
+    // Locate each section
+    const SnapshotFlight *flight_records = (const SnapshotFlight *)(data + sizeof(SnapshotHeader));
+    const SnapshotPassenger *passenger_records = (const SnapshotPassenger *)(flight_records + header.flight_count);
+    const uint32_t *reservation_records = (const uint32_t *)(passenger_records + header.passenger_count);
+    const char *strings = (const char *)(reservation_records + header.reservation_count);
+
+    // Allocate arrays for the nodes (one extra element so an empty dataset never allocates 0 bytes)
+    Flight **loaded_flights = (Flight **)malloc(sizeof(Flight *) * (header.flight_count + 1));
+    Passenger **loaded_passengers = (Passenger **)malloc(sizeof(Passenger *) * (header.passenger_count + 1));
+    if (loaded_flights == NULL || loaded_passengers == NULL) // If malloc failed
+    {
+        free(loaded_flights);
+        free(loaded_passengers);
+        fdb_out_of_memory();
+    }
+
+    // Build the Flight nodes
+    uint32_t flight_count = 0, passenger_count = 0;
+    bool valid = true;
+    for (; flight_count < header.flight_count && valid; flight_count++)
+    {
+        const SnapshotFlight *record = &flight_records[flight_count];
+        Flight *f_temp = create_flight_node(db);
+        loaded_flights[flight_count] = f_temp;
+
+        f_temp->flight_id = snapshot_string(db, strings, header.string_table_size, record->flight_id);
+        if (record->origin < header.string_table_size && record->destination < header.string_table_size)
+        {
+            f_temp->origin = intern_string(&db->airport_table, (char *)strings + record->origin);
+            f_temp->destination = intern_string(&db->airport_table, (char *)strings + record->destination);
+        }
+        f_temp->departure = (DateTime){.date = {record->departure[0], record->departure[1], record->departure[2]},
+                                       .time = {record->departure[3], record->departure[4]}};
+        f_temp->arrival = (DateTime){.date = {record->arrival[0], record->arrival[1], record->arrival[2]},
+                                     .time = {record->arrival[3], record->arrival[4]}};
+        f_temp->passenger_qty = record->passenger_qty;
+        f_temp->passenger_max = record->passenger_max;
+        f_temp->bonus_miles = record->bonus_miles;
+        update_flight_minutes(f_temp);
+
+        valid = f_temp->flight_id != NULL && f_temp->origin != NULL && f_temp->destination != NULL &&
+                f_temp->departure.date.month >= 1 && f_temp->departure.date.month <= 12 &&
+                f_temp->arrival.date.month >= 1 && f_temp->arrival.date.month <= 12;
+    }
+
+    // Build the Passenger nodes and their reservations
+    for (; passenger_count < header.passenger_count && valid; passenger_count++)
+    {
+        const SnapshotPassenger *record = &passenger_records[passenger_count];
+        Passenger *p_temp = create_passenger_node(db);
+        loaded_passengers[passenger_count] = p_temp;
+
+        p_temp->first_name = snapshot_string(db, strings, header.string_table_size, record->first_name);
+        p_temp->last_name = snapshot_string(db, strings, header.string_table_size, record->last_name);
+        p_temp->passport_number = snapshot_string(db, strings, header.string_table_size, record->passport_number);
+        p_temp->birth_date = (Date){record->birth_date[0], record->birth_date[1], record->birth_date[2]};
+        p_temp->miles = record->miles;
+
+        valid = p_temp->first_name != NULL && p_temp->last_name != NULL && p_temp->passport_number != NULL &&
+                p_temp->birth_date.month >= 1 && p_temp->birth_date.month <= 12 &&
+                record->reservation_start <= header.reservation_count &&
+                record->reservation_qty <= header.reservation_count - record->reservation_start;
+
+        for (uint32_t i = 0; i < record->reservation_qty && valid; i++)
+        {
+            // Reservations are stored as indices into the Flight records
+            uint32_t flight_index = reservation_records[record->reservation_start + i];
+            if (flight_index >= header.flight_count)
+            {
+                valid = false;
+                break;
+            }
+            Flight *reserved_flight = loaded_flights[flight_index];
+            insert_reservation_node(&p_temp->reservations, create_reservation_node(db, p_temp, reserved_flight));
+            schedule_insert(db, &p_temp->schedule, reserved_flight);
+            p_temp->reservation_qty++;
+        }
+    }
+    munmap((void *)data, file_size);
+
+    // Free everything built so far if the snapshot was corrupted (the text files will be loaded instead)
+    if (!valid)
+    {
+        for (uint32_t i = 0; i < passenger_count; i++)
+        {
+            free_passenger_node(db, loaded_passengers[i]);
+        }
+        for (uint32_t i = 0; i < flight_count; i++)
+        {
+            free_flight_node(db, loaded_flights[i]);
+        }
+        free(loaded_flights);
+        free(loaded_passengers);
+        return false;
+    }
+
+    // Snapshots are saved in order, but sort in case the order ever changes
+    if (!items_are_sorted((void **)loaded_flights, (int)flight_count, flight_item_compare))
+    {
+        sort_items((void **)loaded_flights, (int)flight_count, flight_item_compare);
+    }
+    if (!items_are_sorted((void **)loaded_passengers, (int)passenger_count, passenger_item_compare))
+    {
+        sort_items((void **)loaded_passengers, (int)passenger_count, passenger_item_compare);
+    }
+
+    // Link the nodes to the Linked Lists in one pass
+    link_flight_array(db, loaded_flights, (int)flight_count);
+    link_passenger_array(db, loaded_passengers, (int)passenger_count);
+    free(loaded_flights);
+    free(loaded_passengers);
+
+    // Journal records up to this one are already part of the snapshot
+    *journal_sequence = header.journal_sequence;
+
+    return true;
+}
+
+bool snapshot_is_current(FlightDB *db, char *filename)
+{
+    // Variables
+    struct stat snapshot_stat, text_stat;
+    char text_filename[MAX_FILENAME_LENGTH];
+
+    // The snapshot must exist
+    if (stat(filename, &snapshot_stat) != 0)
+    {
+        return false;
+    }
+
+    // Text files that are newer than the snapshot were edited or imported, so they win
+    database_path(db, text_filename, FLIGHTS_FILE, 0);
+    if (stat(text_filename, &text_stat) == 0 && text_stat.st_mtime > snapshot_stat.st_mtime)
+    {
+        return false;
+    }
+    database_path(db, text_filename, PASSENGERS_FILE, 0);
+    if (stat(text_filename, &text_stat) == 0 && text_stat.st_mtime > snapshot_stat.st_mtime)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+int journal_open(FlightDB *db, char *filename)
+{
+    // Open the journal for appending
+    db->journal.fp = fopen(filename, "a");
+    if (db->journal.fp == NULL)
+    {
+        return FDB_JOURNAL_FAILED; // Changes will only be saved by fdb_save()
+    }
+
+    // A new journal starts with a header holding the sequence number it continues from
+    fseek(db->journal.fp, 0, SEEK_END);
+    db->journal.size = ftell(db->journal.fp);
+    if (db->journal.size == 0)
+    {
+        fprintf(db->journal.fp, "JOURNAL %lld\n", db->journal.sequence);
+        journal_sync(db);
+        sync_directory(db);
+        db->journal.size = ftell(db->journal.fp);
+    }
+
+    return FDB_OK;
+}
+
+void journal_close(FlightDB *db)
+{
+    // Close the journal if it is open
+    if (db->journal.fp != NULL)
+    {
+        fclose(db->journal.fp);
+        db->journal.fp = NULL;
+    }
+}
+
+void journal_begin(FlightDB *db, int op)
+{
+    // Start a record with its sequence number and operation (the lock is held until journal_end())
+    pthread_mutex_lock(&db->journal_lock);
+    db->journal.sequence++;
+    if (db->journal.fp != NULL)
+    {
+        fprintf(db->journal.fp, "%lld %s\n", db->journal.sequence, JOURNAL_OPS[op]);
+    }
+}
+
+void journal_end(FlightDB *db)
+{
+    // A record only counts once its END line is written (a record cut short by a crash is ignored)
+    if (db->journal.fp != NULL)
+    {
+        fprintf(db->journal.fp, "END\n");
+        if (!db->journal.batching)
+        {
+            journal_sync(db);
+        }
+        db->journal.size = ftell(db->journal.fp);
+    }
+    pthread_mutex_unlock(&db->journal_lock);
+}
+
+void journal_sync(FlightDB *db)
+{
+    // Flush the stdio buffer, then the kernel's, so a finished change survives a power loss and not only a crash of the program
+    fflush(db->journal.fp);
+    fdatasync(fileno(db->journal.fp));
+}
+
+void journal_replay(FlightDB *db, char *filename, long long base_sequence, LoadReport *report)
+{
+    // Variables
+    char op_name[JOURNAL_OP_SIZE];
+    char *fields[JOURNAL_MAX_FIELDS];
+    long long sequence, header_sequence;
+    long good_size = 0; // The size of the journal up to the last complete record
+
+    // If there is no journal, there is nothing to replay
+    FILE *fp = fopen(filename, "r");
+    if (fp == NULL)
+    {
+        db->journal.sequence = (base_sequence < 0) ? 0 : base_sequence;
+        return;
+    }
+
+    // Read the header (text files do not store a sequence number, so they continue from the header)
+    char *header = read_line(fp);
+    if (sscanf(header, "JOURNAL %lld", &header_sequence) != 1)
+    {
+        free(header);
+        fclose(fp);
+        report->journal_status = FDB_JOURNAL_INVALID;
+        db->journal.sequence = (base_sequence < 0) ? 0 : base_sequence;
+        return;
+    }
+    free(header);
+    if (base_sequence < 0)
+    {
+        base_sequence = header_sequence;
+    }
+    db->journal.sequence = base_sequence;
+    good_size = ftell(fp);
+
+    // Replay every complete record
+    db->journal.replaying = true;
+    while (!feof(fp))
+    {
+        // Read the record's sequence number and operation
+        char *line = read_line(fp);
+        int op = -1;
+        if (sscanf(line, "%lld %31s", &sequence, op_name) == 2)
+        {
+            for (int i = 0; i < JOURNAL_OP_COUNT; i++)
+            {
+                if (strcmp(op_name, JOURNAL_OPS[i]) == 0)
+                {
+                    op = i;
+                }
+            }
+        }
+        free(line);
+        if (op == -1)
+        {
+            break;
+        }
+
+        // Read its fields and the END line
+        for (int i = 0; i < JOURNAL_OP_FIELDS[op]; i++)
+        {
+            fields[i] = read_line(fp);
+        }
+        char *end = read_line(fp);
+        bool complete = strcmp(end, "END") == 0;
+        free(end);
+
+        // Apply the record unless it is already part of the loaded data
+        if (complete)
+        {
+            good_size = ftell(fp);
+            if (sequence > base_sequence)
+            {
+                if (journal_apply(db, op, fields))
+                {
+                    report->replayed++;
+                }
+                else
+                {
+                    report->skipped++;
+                }
+                db->journal.sequence = sequence;
+            }
+        }
+
+        for (int i = 0; i < JOURNAL_OP_FIELDS[op]; i++)
+        {
+            free(fields[i]);
+        }
+        if (!complete)
+        {
+            break;
+        }
+    }
+    db->journal.replaying = false;
+    fclose(fp);
+
+    // Cut off a record that was cut short by a crash so new records follow the last complete one
+    if (truncate(filename, good_size) != 0)
+    {
+        report->journal_status = FDB_JOURNAL_FAILED;
+    }
+}
+
+bool journal_apply(FlightDB *db, int op, char **fields)
+{
+    // Variables
+    long long values[3];
+    Flight *flight = NULL;
+    Passenger *passenger = NULL;
+    Date birth_date;
+
+    switch (op)
+    {
+    case JOURNAL_ADD_FLIGHT: // ID, origin, destination, departure, arrival, max seats, bonus miles
+        if (search_flight_node(db, fields[0]) != NULL || !parse_long_long(fields[3], &values[0]) ||
+            !parse_long_long(fields[4], &values[1]))
+        {
+            return false;
+        }
+        flight = create_flight_node(db);
+        flight->flight_id = arena_string(&db->arena, fields[0]);
+        flight->origin = intern_string(&db->airport_table, fields[1]);
+        flight->destination = intern_string(&db->airport_table, fields[2]);
+        flight->departure = minutes_to_datetime(values[0]);
+        flight->arrival = minutes_to_datetime(values[1]);
+        flight->passenger_max = atoi(fields[5]);
+        flight->bonus_miles = atoi(fields[6]);
+        update_flight_minutes(flight);
+        commit_add_flight(db, flight);
+        return true;
+
+    case JOURNAL_EDIT_FLIGHT: // ID, departure, arrival, max seats
+        if ((flight = search_flight_node(db, fields[0])) == NULL || !parse_long_long(fields[1], &values[0]) ||
+            !parse_long_long(fields[2], &values[1]))
+        {
+            return false;
+        }
+        set_flight_times(db, flight, minutes_to_datetime(values[0]), minutes_to_datetime(values[1]));
+        flight->passenger_max = atoi(fields[3]);
+        commit_edit_flight(db, flight);
+        return true;
+
+    case JOURNAL_DELETE_FLIGHT: // ID
+        if ((flight = search_flight_node(db, fields[0])) == NULL)
+        {
+            return false;
+        }
+        commit_delete_flight(db, flight);
+        return true;
+
+    case JOURNAL_ADD_PASSENGER: // passport number, first name, last name, birth date, miles
+        if (search_passenger_node(db, fields[0]) != NULL ||
+            sscanf(fields[3], "%d %d %d", &birth_date.day, &birth_date.month, &birth_date.year) != 3)
+        {
+            return false;
+        }
+        passenger = create_passenger_node(db);
+        passenger->passport_number = arena_string(&db->arena, fields[0]);
+        passenger->first_name = arena_string(&db->arena, fields[1]);
+        passenger->last_name = arena_string(&db->arena, fields[2]);
+        passenger->birth_date = birth_date;
+        passenger->miles = atoi(fields[4]);
+        commit_add_passenger(db, passenger);
+        return true;
+
+    case JOURNAL_EDIT_PASSENGER: // passport number, last name, birth date
+        if ((passenger = search_passenger_node(db, fields[0])) == NULL ||
+            sscanf(fields[2], "%d %d %d", &birth_date.day, &birth_date.month, &birth_date.year) != 3)
+        {
+            return false;
+        }
+        arena_free_string(&db->arena, passenger->last_name);
+        passenger->last_name = arena_string(&db->arena, fields[1]);
+        passenger->birth_date = birth_date;
+        commit_edit_passenger(db, passenger);
+        return true;
+
+    case JOURNAL_BOOK_RESERVATION: // passport number, flight ID
+        if ((passenger = search_passenger_node(db, fields[0])) == NULL || (flight = search_flight_node(db, fields[1])) == NULL ||
+            schedule_contains(db, &passenger->schedule, flight) || !claim_seat(flight))
+        {
+            return false;
+        }
+        commit_book_reservation(db, passenger, flight);
+        return true;
+
+    case JOURNAL_REMOVE_RESERVATION: // passport number, flight ID, revoke miles (1 or 0)
+        if ((passenger = search_passenger_node(db, fields[0])) == NULL || (flight = search_flight_node(db, fields[1])) == NULL ||
+            search_reservation_node(passenger->reservations, flight) == NULL)
+        {
+            return false;
+        }
+        commit_remove_reservation(db, passenger, flight, atoi(fields[2]) != 0);
+        return true;
+    }
+
+    return false;
+}
+
+int journal_compact(FlightDB *db)
+{
+    // Variables
+    char temp_filename[MAX_FILENAME_LENGTH], filename[MAX_FILENAME_LENGTH];
+
+    // Save everything (the snapshot records the last journal sequence number it includes)
+    int status = save(db);
+    if (status == FDB_SAVE_FAILED)
+    {
+        return status; // Keep appending to the current journal
+    }
+
+    // Write an empty journal that continues from that sequence number and swap it in
+    database_path(db, temp_filename, JOURNAL_TEMP_FILE, 0);
+    database_path(db, filename, JOURNAL_FILE, 0);
+    FILE *fp = fopen(temp_filename, "w");
+    if (fp == NULL)
+    {
+        return FDB_JOURNAL_FAILED;
+    }
+    fprintf(fp, "JOURNAL %lld\n", db->journal.sequence);
+    if (!sync_and_close(fp) || rename(temp_filename, filename) != 0)
+    {
+        return FDB_JOURNAL_FAILED;
+    }
+    sync_directory(db);
+
+    // Append to the new journal from now on
+    journal_close(db);
+    int journal_status = journal_open(db, filename);
+    return (journal_status != FDB_OK) ? journal_status : status;
+}
+
+bool parse_long_long(char *string, long long *value)
+{
+    // The whole string must be a number
+    char *end;
+    *value = strtoll(string, &end, 10);
+    return end != string && *end == '\0';
+}
+
+int split_fields(char *line, char **fields, int max_fields)
+{
+    // Variables
+    int count = 0;
+    char *ptr = line;
+
+    while (true)
+    {
+        // Skip the spaces before a field
+        while (*ptr == ' ' || *ptr == '\t' || *ptr == '\r')
+        {
+            ptr++;
+        }
+        if (*ptr == '\0')
+        {
+            return count;
+        }
+        if (count == max_fields)
+        {
+            return -1;
+        }
+
+        // A quoted field runs to its closing quote (so it can contain spaces), any other field to the next space
+        if (*ptr == '"')
+        {
+            fields[count++] = ++ptr;
+            while (*ptr != '"')
+            {
+                if (*ptr == '\0')
+                {
+                    return -1;
+                }
+                ptr++;
+            }
+        }
+        else
+        {
+            fields[count++] = ptr;
+            while (*ptr != '\0' && *ptr != ' ' && *ptr != '\t' && *ptr != '\r')
+            {
+                ptr++;
+            }
+            if (*ptr == '\0')
+            {
+                return count;
+            }
+        }
+
+        // End the field in place
+        *ptr++ = '\0';
+    }
+}
+
+void journal_field(FlightDB *db, const char *format, ...)
+{
+    // Variables
+    va_list args;
+
+    // Write one field per line (like flights.txt and passengers.txt)
+    if (db->journal.fp != NULL)
+    {
+        va_start(args, format);
+        vfprintf(db->journal.fp, format, args);
+        va_end(args);
+        fputc('\n', db->journal.fp);
+    }
+}
+
+void commit_add_flight(FlightDB *db, Flight *flight)
+{
+    // Insert the Flight to the linked list and the availability index
+    insert_flight_node(db, flight);
+    availability_update(&db->available_flights, flight);
+
+    // Journal the change
+    if (!db->journal.replaying)
+    {
+        journal_begin(db, JOURNAL_ADD_FLIGHT);
+        journal_field(db, "%s", flight->flight_id);
+        journal_field(db, "%s", flight->origin);
+        journal_field(db, "%s", flight->destination);
+        journal_field(db, "%lld", flight->departure_minutes);
+        journal_field(db, "%lld", flight->arrival_minutes);
+        journal_field(db, "%d", flight->passenger_max);
+        journal_field(db, "%d", flight->bonus_miles);
+        journal_end(db);
+    }
+}
+
+void commit_edit_flight(FlightDB *db, Flight *flight)
+{
+    // Reinsert the Flight so the linked list and the availability index stay in order
+    // (set_flight_times() already took it out of the availability index)
+    reinsert_flight_node(db, flight);
+    availability_update(&db->available_flights, flight);
+
+    // Passengers who booked this Flight have to recompute their schedules
+    if (flight->passenger_qty != 0)
+    {
+        db->schedule_version++;
+    }
+
+    // Journal the change
+    if (!db->journal.replaying)
+    {
+        journal_begin(db, JOURNAL_EDIT_FLIGHT);
+        journal_field(db, "%s", flight->flight_id);
+        journal_field(db, "%lld", flight->departure_minutes);
+        journal_field(db, "%lld", flight->arrival_minutes);
+        journal_field(db, "%d", flight->passenger_max);
+        journal_end(db);
+    }
+}
+
+void commit_delete_flight(FlightDB *db, Flight *flight)
+{
+    // Journal the change (before the Flight ID is freed)
+    if (!db->journal.replaying)
+    {
+        journal_begin(db, JOURNAL_DELETE_FLIGHT);
+        journal_field(db, "%s", flight->flight_id);
+        journal_end(db);
+    }
+
+    // Only an arrived Flight can still have reservations, which are removed without revoking miles
+    // (the manifest leads straight to them, so no other Passenger is visited)
+    while (flight->manifest != NULL)
+    {
+        Reservation *r_ptr = flight->manifest;
+        Passenger *p_ptr = r_ptr->passenger;
+        flight->passenger_qty--;
+        p_ptr->reservation_qty--;
+        schedule_remove(db, &p_ptr->schedule, flight);
+        remove_reservation_node(db, &p_ptr->reservations, r_ptr);
+    }
+
+    // Delete the Flight
+    availability_remove(&db->available_flights, flight);
+    delete_flight_node(db, flight);
+}
+
+void commit_add_passenger(FlightDB *db, Passenger *passenger)
+{
+    // Insert the Passenger to the linked list
+    insert_passenger_node(db, passenger);
+
+    // Journal the change
+    if (!db->journal.replaying)
+    {
+        journal_begin(db, JOURNAL_ADD_PASSENGER);
+        journal_field(db, "%s", passenger->passport_number);
+        journal_field(db, "%s", passenger->first_name);
+        journal_field(db, "%s", passenger->last_name);
+        journal_field(db, "%d %d %d", passenger->birth_date.day, passenger->birth_date.month, passenger->birth_date.year);
+        journal_field(db, "%d", passenger->miles);
+        journal_end(db);
+    }
+}
+
+void commit_edit_passenger(FlightDB *db, Passenger *passenger)
+{
+    // The new details are already set, so only journal the change
+    if (!db->journal.replaying)
+    {
+        journal_begin(db, JOURNAL_EDIT_PASSENGER);
+        journal_field(db, "%s", passenger->passport_number);
+        journal_field(db, "%s", passenger->last_name);
+        journal_field(db, "%d %d %d", passenger->birth_date.day, passenger->birth_date.month, passenger->birth_date.year);
+        journal_end(db);
+    }
+}
+
+bool claim_seat(Flight *flight)
+{
+    // Take a seat only if the count is still the one checked (another thread may have taken the last seat in between)
+    int booked = atomic_load(&flight->passenger_qty);
+    do
+    {
+        if (booked >= flight->passenger_max)
+        {
+            return false; // Return false if the Flight is full
+        }
+    } while (!atomic_compare_exchange_weak(&flight->passenger_qty, &booked, booked + 1));
+
+    return true; // Return true once the seat is taken
+}
+
+void commit_book_reservation(FlightDB *db, Passenger *passenger, Flight *flight)
+{
+    // Insert a new Reservation node to the passenger's reservations linked list and schedule
+    insert_reservation_node(&passenger->reservations, create_reservation_node(db, passenger, flight));
+    schedule_insert(db, &passenger->schedule, flight);
+
+    // Update passenger details (the seat was already claimed) and take the Flight out of the availability index once it is full
+    passenger->reservation_qty++;
+    passenger->miles += flight->bonus_miles;
+    pthread_mutex_lock(&db->availability_lock);
+    availability_update(&db->available_flights, flight);
+    pthread_mutex_unlock(&db->availability_lock);
+
+    // Journal the change (only after the seat was claimed, so it follows the cancellation that freed the seat)
+    if (!db->journal.replaying)
+    {
+        journal_begin(db, JOURNAL_BOOK_RESERVATION);
+        journal_field(db, "%s", passenger->passport_number);
+        journal_field(db, "%s", flight->flight_id);
+        journal_end(db);
+    }
+}
+
+void commit_remove_reservation(FlightDB *db, Passenger *passenger, Flight *flight, bool revoke_miles)
+{
+    // Update passenger details (a cancellation also revokes the bonus miles)
+    passenger->reservation_qty--;
+    if (revoke_miles)
+    {
+        passenger->miles -= flight->bonus_miles;
+    }
+
+    // Journal the change before the seat is freed, so a booking that takes the seat is always journaled after it (replay checks the seats again)
+    if (!db->journal.replaying)
+    {
+        journal_begin(db, JOURNAL_REMOVE_RESERVATION);
+        journal_field(db, "%s", passenger->passport_number);
+        journal_field(db, "%s", flight->flight_id);
+        journal_field(db, "%d", revoke_miles ? 1 : 0);
+        journal_end(db);
+    }
+
+    // Free the seat and put the Flight back in the availability index
+    atomic_fetch_sub(&flight->passenger_qty, 1);
+    pthread_mutex_lock(&db->availability_lock);
+    availability_update(&db->available_flights, flight);
+    pthread_mutex_unlock(&db->availability_lock);
+
+    // Remove the Reservation from the passenger's schedule and reservations linked list
+    schedule_remove(db, &passenger->schedule, flight);
+    delete_reservation_node(db, &passenger->reservations, flight);
+}
+
+FlightDB *fdb_create(const char *directory)
+{
+    // Leave room after the directory for the longest file name (a save generation's passengers file)
+    if (directory != NULL && strlen(directory) >= MAX_FILENAME_LENGTH - 64)
+    {
+        return NULL;
+    }
+
+    // Allocate memory for the database
+    FlightDB *db = (FlightDB *)malloc(sizeof(FlightDB));
+    if (db == NULL) // If malloc failed
+    {
+        fdb_out_of_memory();
+    }
+
+    // Initialize fields to defaults (every index starts empty)
+    *db = (FlightDB){
+        .directory = "",
+        .flights = NULL,
+        .passengers = NULL,
+        .arena = {.slabs = NULL, .free_lists = {NULL}},
+        .flight_order = {.heads = {NULL}, .level = 1},
+        .airport_table = {.slots = NULL, .capacity = 0, .count = 0},
+        .flight_table = {.slots = NULL, .capacity = 0, .count = 0},
+        .passenger_table = {.slots = NULL, .capacity = 0, .count = 0},
+        .schedule_version = 0,
+        .available_flights = {.flights = NULL, .size = 0, .capacity = 0, .now = 0, .columns = {{0}, {0}, {0}, {0}}},
+        .route_table = {.slots = NULL, .capacity = 0, .count = 0},
+        .flight_columns = {{0}, {0}, {0}, {0}},
+        .save_generation = 0,
+        .journal = {.fp = NULL, .size = 0, .sequence = 0, .replaying = false, .batching = false},
+        .lock = PTHREAD_RWLOCK_INITIALIZER,
+        .arena_lock = PTHREAD_MUTEX_INITIALIZER,
+        .availability_lock = PTHREAD_MUTEX_INITIALIZER,
+        .journal_lock = PTHREAD_MUTEX_INITIALIZER};
+
+    // Every file name is put after the directory, so make sure it ends with a '/'
+    if (directory != NULL && directory[0] != '\0')
+    {
+        size_t length = strlen(directory);
+        snprintf(db->directory, MAX_FILENAME_LENGTH, "%s%s", directory, (directory[length - 1] == '/') ? "" : "/");
+    }
+
+    // Read the clock before loading so Flights that already departed never enter the availability index
+    fdb_update_time(db);
+
+    return db; // Return the database
+}
+
+int fdb_save(FlightDB *db)
+{
+    // Saving folds the journal into the new save generation (with no change running)
+    pthread_rwlock_wrlock(&db->lock);
+    int status = journal_compact(db);
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+int fdb_maintain(FlightDB *db)
+{
+    // Variables
+    int status = FDB_OK;
+
+    // Fold the journal into a new save once it grows too large (with no change running)
+    pthread_rwlock_wrlock(&db->lock);
+    if (db->journal.size >= JOURNAL_COMPACT_SIZE)
+    {
+        status = journal_compact(db);
+    }
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+void fdb_close(FlightDB *db)
+{
+    if (db == NULL)
+    {
+        return;
+    }
+
+    // Close the journal (every finished change is already synced to it)
+    journal_close(db);
+
+    // Free allocated memory
+    free_database(db);
+    free_flight_table(&db->flight_table);
+    free_passenger_table(&db->passenger_table);
+    free_intern_table(&db->airport_table);
+    free_availability_index(&db->available_flights);
+    free_route_table(&db->route_table);
+    pthread_rwlock_destroy(&db->lock);
+    pthread_mutex_destroy(&db->arena_lock);
+    pthread_mutex_destroy(&db->availability_lock);
+    pthread_mutex_destroy(&db->journal_lock);
+    free(db);
+}
+
+void fdb_set_memory_handler(void (*handler)())
+{
+    memory_handler = handler;
+}
+
+void fdb_out_of_memory()
+{
+    // Let the program clean up and exit (the handler should not return)
+    if (memory_handler != NULL)
+    {
+        memory_handler();
+    }
+
+    // Exit either way, since there is nothing to return to
+    fprintf(stderr, "Oops! Memory allocation failed.\n");
+    exit(EXIT_FAILURE);
+}
+
+const char *fdb_status_message(int status)
+{
+    return (status >= 0 && status < FDB_STATUS_COUNT) ? STATUS_MESSAGES[status] : "Unknown status.";
+}
+
+void fdb_set_time(FlightDB *db, DateTime now)
+{
+    // Set the clock snapshot and drop every Flight that departed by then from the bookable Flights (with no change running)
+    pthread_rwlock_wrlock(&db->lock);
+    db->current_datetime = now;
+    db->current_minutes = datetime_to_minutes(now);
+    availability_advance(&db->available_flights, db->current_minutes);
+    pthread_rwlock_unlock(&db->lock);
+}
+
+DateTime fdb_now(FlightDB *db)
+{
+    return db->current_datetime;
+}
+
+long long fdb_now_minutes(FlightDB *db)
+{
+    return db->current_minutes;
+}
+
+Flight *fdb_flights(FlightDB *db)
+{
+    return db->flights;
+}
+
+Passenger *fdb_passengers(FlightDB *db)
+{
+    return db->passengers;
+}
+
+Flight *fdb_find_flight(FlightDB *db, char *flight_id)
+{
+    return search_flight_node(db, flight_id);
+}
+
+Passenger *fdb_find_passenger(FlightDB *db, char *passport_number)
+{
+    return search_passenger_node(db, passport_number);
+}
+
+Flight *fdb_available_flight(FlightDB *db, int position)
+{
+    return availability_at(&db->available_flights, position);
+}
+
+RouteView fdb_search_route(FlightDB *db, char *origin, char *destination, long long departure)
+{
+    // Find the interned airports (an airport no Flight uses has no routes), then the route, then the first of its Flights
+    // departing at or after the time (the rest follow it in order)
+    origin = intern_lookup(&db->airport_table, origin);
+    destination = intern_lookup(&db->airport_table, destination);
+    Route *route = (origin != NULL && destination != NULL) ? route_table_search(&db->route_table, origin, destination) : NULL;
+    if (route == NULL)
+    {
+        return (RouteView){.flights = NULL, .count = 0};
+    }
+    int position = route_lower_bound(route, departure);
+    return (RouteView){.flights = route->flights + position, .count = route->size - position};
+}
+
+const ColumnWidths *fdb_column_widths(FlightDB *db, bool available)
+{
+    return available ? &db->available_flights.columns : &db->flight_columns;
+}
+
+FlightStatus fdb_flight_status(FlightDB *db, Flight *flight)
+{
+    return retrieve_flight_status(flight, db->current_minutes);
+}
+
+Flight *fdb_find_conflict(FlightDB *db, Passenger *passenger, Flight *flight)
+{
+    // The check can rebuild the Passenger's Schedule, so it takes the Passenger's lock like fdb_book()
+    pthread_mutex_lock(&passenger->lock);
+    Flight *conflict = schedule_find_conflict(db, &passenger->schedule, flight);
+    pthread_mutex_unlock(&passenger->lock);
+    return conflict;
+}
+
+int fdb_find_itinerary(FlightDB *db, char *origin, char *destination, long long departure, char *passport_number, Itinerary *itinerary)
+{
+    // Variables
+    Passenger *passenger = NULL;
+    ItineraryStops stops;
+    AvailabilityIndex *index = &db->available_flights;
+
+    *itinerary = (Itinerary){.legs = {NULL}, .leg_count = 0};
+
+    // Find the Passenger and the interned airports (an airport no Flight uses cannot be reached)
+    if (passport_number != NULL && (passenger = search_passenger_node(db, passport_number)) == NULL)
+    {
+        return FDB_PASSENGER_NOT_FOUND;
+    }
+    origin = intern_lookup(&db->airport_table, origin);
+    destination = intern_lookup(&db->airport_table, destination);
+    if (origin == NULL || destination == NULL)
+    {
+        return FDB_NO_ITINERARY;
+    }
+    if (origin == destination)
+    {
+        return FDB_SAME_AIRPORTS;
+    }
+
+    // Allocate at least twice as many stops as there are airports
+    stops.capacity = INDEX_INITIAL_CAPACITY;
+    while (stops.capacity < db->airport_table.count * 2)
+    {
+        stops.capacity *= 2;
+    }
+    stops.slots = (ItineraryStop *)calloc(stops.capacity, sizeof(ItineraryStop));
+    if (stops.slots == NULL) // If calloc failed
+    {
+        fdb_out_of_memory();
+    }
+    ItineraryStop *start = itinerary_stop(&stops, origin, true);
+    start->arrival = departure;
+    ItineraryStop *goal = itinerary_stop(&stops, destination, true);
+
+    // Connection Scan: go through the bookable Flights in order of departure, and take a Flight if it departs after arriving
+    // at its origin (with time to connect) and arrives at its destination earlier than known. A Flight departing after the
+    // earliest arrival at the destination cannot arrive before it, so the scan stops there.
+    for (int i = availability_first_departure(index, departure); i < index->size && index->flights[i]->departure_minutes < goal->arrival; i++)
+    {
+        Flight *flight = index->flights[i];
+        ItineraryStop *from = itinerary_stop(&stops, flight->origin, false);
+        if (from == NULL || from->arrival == LLONG_MAX || from->legs == MAX_ITINERARY_LEGS ||
+            flight->departure_minutes < from->arrival + ((from->via != NULL) ? MIN_CONNECTION_MINUTES : 0))
+        {
+            continue;
+        }
+        ItineraryStop *to = itinerary_stop(&stops, flight->destination, true);
+        if (flight->arrival_minutes >= to->arrival || !itinerary_leg_allowed(db, passenger, flight))
+        {
+            continue;
+        }
+        *to = (ItineraryStop){.airport = to->airport, .arrival = flight->arrival_minutes, .via = flight, .legs = from->legs + 1};
+    }
+
+    // Follow the Flights back from the destination (a stop is never improved after a Flight leaves it, since every later
+    // Flight departs after that Flight, so the chain has exactly goal->legs Flights)
+    if (goal->via != NULL)
+    {
+        itinerary->leg_count = goal->legs;
+        int leg = goal->legs;
+        for (ItineraryStop *stop = goal; stop->via != NULL; stop = itinerary_stop(&stops, stop->via->origin, false))
+        {
+            itinerary->legs[--leg] = stop->via;
+        }
+    }
+    free(stops.slots);
+
+    return (itinerary->leg_count > 0) ? FDB_OK : FDB_NO_ITINERARY;
+}
+
+int fdb_add_flight(FlightDB *db, char *flight_id, char *origin, char *destination,
+                   DateTime departure, Time duration, int passenger_max, int bonus_miles)
+{
+    // Every change except bookings and cancellations runs alone
+    pthread_rwlock_wrlock(&db->lock);
+    int status = apply_add_flight(db, flight_id, origin, destination, departure, duration, passenger_max, bonus_miles);
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+int apply_add_flight(FlightDB *db, char *flight_id, char *origin, char *destination,
+                     DateTime departure, Time duration, int passenger_max, int bonus_miles)
+{
+    // Validate the fields in the order the menu asks for them
+    if (!is_valid_id(flight_id))
+    {
+        return FDB_INVALID_FLIGHT_ID;
+    }
+    if (search_flight_node(db, flight_id) != NULL)
+    {
+        return FDB_FLIGHT_EXISTS;
+    }
+    if (!is_valid_nonempty_string(origin) || !is_valid_nonempty_string(destination))
+    {
+        return FDB_EMPTY_AIRPORT;
+    }
+    if (strcmp(origin, destination) == 0)
+    {
+        return FDB_SAME_AIRPORTS;
+    }
+    if (!is_future(db->current_datetime, departure))
+    {
+        return FDB_DEPARTURE_PAST;
+    }
+    if (!is_valid_duration(duration))
+    {
+        return FDB_INVALID_DURATION;
+    }
+    if (passenger_max < MIN_PASSENGERS_PER_FLIGHT)
+    {
+        return FDB_INVALID_SEATS;
+    }
+    if (bonus_miles < 0)
+    {
+        return FDB_INVALID_BONUS_MILES;
+    }
+
+    // Create the Flight (airport names are shared through the intern table)
+    Flight *flight = create_flight_node(db);
+    flight->flight_id = arena_string(&db->arena, flight_id);
+    flight->origin = intern_string(&db->airport_table, origin);
+    flight->destination = intern_string(&db->airport_table, destination);
+    flight->departure = departure;
+    flight->arrival = compute_arrival_datetime(departure, duration);
+    flight->passenger_max = passenger_max;
+    flight->bonus_miles = bonus_miles;
+    update_flight_minutes(flight);
+
+    // Insert it and journal it
+    commit_add_flight(db, flight);
+    return FDB_OK;
+}
+
+int fdb_edit_flight(FlightDB *db, char *flight_id, DateTime departure, Time duration, int passenger_max)
+{
+    // Every change except bookings and cancellations runs alone
+    pthread_rwlock_wrlock(&db->lock);
+    int status = apply_edit_flight(db, flight_id, departure, duration, passenger_max);
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+int apply_edit_flight(FlightDB *db, char *flight_id, DateTime departure, Time duration, int passenger_max)
+{
+    // Variables
+    Flight *flight = search_flight_node(db, flight_id);
+    FlightStatus status;
+
+    // Only a Flight that has not departed can be edited
+    if (flight == NULL)
+    {
+        return FDB_FLIGHT_NOT_FOUND;
+    }
+    status = retrieve_flight_status(flight, db->current_minutes);
+    if (status.flight_departed)
+    {
+        return status.flight_arrived ? FDB_FLIGHT_ARRIVED : FDB_FLIGHT_ONGOING;
+    }
+
+    // Validate the new fields
+    if (!is_future(db->current_datetime, departure))
+    {
+        return FDB_DEPARTURE_PAST;
+    }
+    if (!is_valid_duration(duration))
+    {
+        return FDB_INVALID_DURATION;
+    }
+    if (passenger_max < MIN_PASSENGERS_PER_FLIGHT)
+    {
+        return FDB_INVALID_SEATS;
+    }
+    if (passenger_max < flight->passenger_qty)
+    {
+        return FDB_SEATS_BELOW_BOOKED;
+    }
+
+    // Change the Flight, then reorder it and journal it
+    set_flight_times(db, flight, departure, compute_arrival_datetime(departure, duration));
+    flight->passenger_max = passenger_max;
+    commit_edit_flight(db, flight);
+    return FDB_OK;
+}
+
+int fdb_delete_flight(FlightDB *db, char *flight_id)
+{
+    // Every change except bookings and cancellations runs alone
+    pthread_rwlock_wrlock(&db->lock);
+    int status = apply_delete_flight(db, flight_id);
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+int apply_delete_flight(FlightDB *db, char *flight_id)
+{
+    // Variables
+    Flight *flight = search_flight_node(db, flight_id);
+
+    // A booked Flight can only be deleted once it has arrived
+    if (flight == NULL)
+    {
+        return FDB_FLIGHT_NOT_FOUND;
+    }
+    if (!retrieve_flight_status(flight, db->current_minutes).flight_arrived && flight->passenger_qty != 0)
+    {
+        return FDB_FLIGHT_BOOKED;
+    }
+
+    // Remove its reservations, delete it, and journal it
+    commit_delete_flight(db, flight);
+    return FDB_OK;
+}
+
+int fdb_add_passenger(FlightDB *db, char *passport_number, char *first_name, char *last_name, Date birth_date, int miles)
+{
+    // Every change except bookings and cancellations runs alone
+    pthread_rwlock_wrlock(&db->lock);
+    int status = apply_add_passenger(db, passport_number, first_name, last_name, birth_date, miles);
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+int apply_add_passenger(FlightDB *db, char *passport_number, char *first_name, char *last_name, Date birth_date, int miles)
+{
+    // Validate the fields in the order the menu asks for them
+    if (!is_valid_passport(passport_number))
+    {
+        return FDB_INVALID_PASSPORT;
+    }
+    if (search_passenger_node(db, passport_number) != NULL)
+    {
+        return FDB_PASSENGER_EXISTS;
+    }
+    if (!is_valid_nonempty_string(first_name) || !is_valid_nonempty_string(last_name))
+    {
+        return FDB_EMPTY_NAME;
+    }
+    if (birth_date.month < 1 || birth_date.month > 12 || !is_valid_day(birth_date.day, birth_date.month, birth_date.year) ||
+        !is_valid_birthdate(birth_date, db->current_datetime))
+    {
+        return FDB_INVALID_BIRTHDATE;
+    }
+    if (miles < 0)
+    {
+        return FDB_INVALID_MILES;
+    }
+
+    // Create the Passenger
+    Passenger *passenger = create_passenger_node(db);
+    passenger->passport_number = arena_string(&db->arena, passport_number);
+    passenger->first_name = arena_string(&db->arena, first_name);
+    passenger->last_name = arena_string(&db->arena, last_name);
+    passenger->birth_date = birth_date;
+    passenger->miles = miles;
+
+    // Insert them and journal it
+    commit_add_passenger(db, passenger);
+    return FDB_OK;
+}
+
+int fdb_edit_passenger(FlightDB *db, char *passport_number, char *last_name, Date birth_date)
+{
+    // Every change except bookings and cancellations runs alone
+    pthread_rwlock_wrlock(&db->lock);
+    int status = apply_edit_passenger(db, passport_number, last_name, birth_date);
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+int apply_edit_passenger(FlightDB *db, char *passport_number, char *last_name, Date birth_date)
+{
+    // Variables
+    Passenger *passenger = search_passenger_node(db, passport_number);
+
+    // Validate the fields
+    if (passenger == NULL)
+    {
+        return FDB_PASSENGER_NOT_FOUND;
+    }
+    if (!is_valid_nonempty_string(last_name))
+    {
+        return FDB_EMPTY_NAME;
+    }
+    if (birth_date.month < 1 || birth_date.month > 12 || !is_valid_day(birth_date.day, birth_date.month, birth_date.year) ||
+        !is_valid_birthdate(birth_date, db->current_datetime))
+    {
+        return FDB_INVALID_BIRTHDATE;
+    }
+
+    // Replace the last name (the old one goes back to the arena) and the birth date, then journal it
+    arena_free_string(&db->arena, passenger->last_name);
+    passenger->last_name = arena_string(&db->arena, last_name);
+    passenger->birth_date = birth_date;
+    commit_edit_passenger(db, passenger);
+    return FDB_OK;
+}
+
+int fdb_book(FlightDB *db, char *passport_number, char *flight_id)
+{
+    // Variables
+    int status;
+
+    // Bookings share the database lock, so they only wait for each other on the same Passenger (or the same Flight's manifest)
+    pthread_rwlock_rdlock(&db->lock);
+    Passenger *passenger = search_passenger_node(db, passport_number);
+    Flight *flight = search_flight_node(db, flight_id);
+
+    // Only a Flight that has not departed, has a free seat, and fits the Passenger's schedule can be booked
+    if (passenger == NULL)
+    {
+        status = FDB_PASSENGER_NOT_FOUND;
+    }
+    else if (flight == NULL)
+    {
+        status = FDB_FLIGHT_NOT_FOUND;
+    }
+    else if (retrieve_flight_status(flight, db->current_minutes).flight_departed)
+    {
+        status = FDB_FLIGHT_DEPARTED;
+    }
+    else if (flight->passenger_qty >= flight->passenger_max)
+    {
+        status = FDB_FLIGHT_FULL;
+    }
+    else
+    {
+        // The Passenger's lock keeps the reservation checks true until the reservation is added
+        pthread_mutex_lock(&passenger->lock);
+        if (schedule_contains(db, &passenger->schedule, flight))
+        {
+            status = FDB_ALREADY_RESERVED;
+        }
+        else if (schedule_find_conflict(db, &passenger->schedule, flight) != NULL)
+        {
+            status = FDB_CONFLICT;
+        }
+        else if (!claim_seat(flight)) // Another thread took the last seat since it was checked
+        {
+            status = FDB_FLIGHT_FULL;
+        }
+        else
+        {
+            // Book it and journal it
+            commit_book_reservation(db, passenger, flight);
+            status = FDB_OK;
+        }
+        pthread_mutex_unlock(&passenger->lock);
+    }
+
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+int fdb_cancel(FlightDB *db, char *passport_number, char *flight_id)
+{
+    // Variables
+    int status;
+    FlightStatus flight_status;
+
+    // Cancellations share the database lock with bookings
+    pthread_rwlock_rdlock(&db->lock);
+    Passenger *passenger = search_passenger_node(db, passport_number);
+    Flight *flight = search_flight_node(db, flight_id);
+
+    // An ongoing Flight cannot be removed from a Passenger's reservations
+    if (passenger == NULL)
+    {
+        status = FDB_PASSENGER_NOT_FOUND;
+    }
+    else if (flight == NULL)
+    {
+        status = FDB_FLIGHT_NOT_FOUND;
+    }
+    else
+    {
+        pthread_mutex_lock(&passenger->lock);
+        flight_status = retrieve_flight_status(flight, db->current_minutes);
+        if (search_reservation_node(passenger->reservations, flight) == NULL)
+        {
+            status = FDB_RESERVATION_NOT_FOUND;
+        }
+        else if (flight_status.flight_departed && !flight_status.flight_arrived)
+        {
+            status = FDB_RESERVATION_ONGOING;
+        }
+        else
+        {
+            // Cancelling a Flight that has not departed revokes its bonus miles
+            commit_remove_reservation(db, passenger, flight, !flight_status.flight_departed);
+            status = FDB_OK;
+        }
+        pthread_mutex_unlock(&passenger->lock);
+    }
+
+    pthread_rwlock_unlock(&db->lock);
+    return status;
+}
+
+void fdb_begin_batch(FlightDB *db)
+{
+    // Journal records are flushed once at the end instead of one by one
+    pthread_mutex_lock(&db->journal_lock);
+    db->journal.batching = true;
+    pthread_mutex_unlock(&db->journal_lock);
+}
+
+void fdb_end_batch(FlightDB *db)
+{
+    // Flush and sync every journal record of the batch at once (one fdatasync() for the whole batch)
+    pthread_mutex_lock(&db->journal_lock);
+    db->journal.batching = false;
+    if (db->journal.fp != NULL)
+    {
+        journal_sync(db);
+    }
+    pthread_mutex_unlock(&db->journal_lock);
+}
@@ -0,0 +1,336 @@
+/*  Tabamo, Euan Jed S. - ST2L - June 2, 2024
+    Final Project - Flight Passenger Management System
+    Flight Database Library - the flights, passengers, and reservations behind the menus
+*/
+
+#ifndef FLIGHTDB_H
+#define FLIGHTDB_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/* Library Constants/Definitions
+    - STR_LEN means is for a strlen(), without the NUL terminator.
+    - SIZE means is for a size, like an array/string, which (for a string) will include the NUL terminator.
+*/
+
+#define FLIGHT_ID_STR_LEN 6    // the strlen() of a flight ID
+#define PASSPORT_NUM_STR_LEN 9 // the strlen() of a passport number
+
+#define MONTH_STR_SIZE 10                   // the maximum array size of a month string (September is the longest string)
+#define LINE_READER_BUFFER_SIZE (64 * 1024) // the initial number of bytes a LineReader reads from a file at once
+#define MAX_FILENAME_LENGTH 256             // the maximum length of a filename
+
+#define MIN_PASSENGERS_PER_FLIGHT 1         // the minimum number of passengers allowed for a flight
+#define MAX_AGE 130                         // the maximum age allowed for a passenger
+#define MIN_FLIGHT_DURATION_IN_MINUTES 1    // the minimum flight duration allowed for a flight
+#define MAX_FLIGHT_DURATION_IN_MINUTES 1130 // the maximum flight duration allowed for a flight (from Singapore (SIN) to New York (JFK))
+#define COLUMN_WIDTH_LIMIT 64               // the number of lengths counted for each listing column (longer strings count as the last one)
+#define MIN_CONNECTION_MINUTES 60           // the minimum number of minutes between arriving on a Flight and departing on the next Flight of an itinerary
+#define MAX_ITINERARY_LEGS 8                // the maximum number of Flights of an itinerary (fdb_find_itinerary() misses an earlier arrival needing more)
+
+#define FLIGHTS_FILE "flights.txt"       // the string representing the file where flights are saved
+#define PASSENGERS_FILE "passengers.txt" // the string representing the file where passengers are saved
+#define JOURNAL_FILE "journal.txt"       // the string representing the file where changes since the last save are appended
+
+/* Status Codes (returned by the fdb_ functions instead of printing, see fdb_status_message()) */
+
+#define FDB_OK 0                     // the change was made
+#define FDB_INVALID_FLIGHT_ID 1      // the flight ID is not 1 to 6 uppercase letters and/or digits
+#define FDB_FLIGHT_EXISTS 2          // a Flight with the flight ID already exists
+#define FDB_FLIGHT_NOT_FOUND 3       // no Flight has the flight ID
+#define FDB_EMPTY_AIRPORT 4          // the origin or the destination is empty
+#define FDB_SAME_AIRPORTS 5          // the destination is the origin
+#define FDB_DEPARTURE_PAST 6         // the departure is not after the database's clock
+#define FDB_INVALID_DURATION 7       // the duration is out of range
+#define FDB_INVALID_SEATS 8          // the maximum number of passengers is below MIN_PASSENGERS_PER_FLIGHT
+#define FDB_SEATS_BELOW_BOOKED 9     // the maximum number of passengers is below the number already booked
+#define FDB_INVALID_BONUS_MILES 10   // the bonus miles are negative
+#define FDB_FLIGHT_ONGOING 11        // the Flight departed but has not arrived
+#define FDB_FLIGHT_ARRIVED 12        // the Flight has arrived
+#define FDB_FLIGHT_DEPARTED 13       // the Flight has departed (so it cannot be booked)
+#define FDB_FLIGHT_FULL 14           // the Flight is fully booked
+#define FDB_FLIGHT_BOOKED 15         // the Flight still has passengers (so it cannot be deleted)
+#define FDB_INVALID_PASSPORT 16      // the passport number is not 9 uppercase letters and/or digits
+#define FDB_PASSENGER_EXISTS 17      // a Passenger with the passport number already exists
+#define FDB_PASSENGER_NOT_FOUND 18   // no Passenger has the passport number
+#define FDB_EMPTY_NAME 19            // the first or the last name is empty
+#define FDB_INVALID_BIRTHDATE 20     // the birth date makes the Passenger older than MAX_AGE
+#define FDB_INVALID_MILES 21         // the miles are negative
+#define FDB_ALREADY_RESERVED 22      // the Passenger already reserved the Flight
+#define FDB_CONFLICT 23              // the Flight overlaps one of the Passenger's reservations (see fdb_find_conflict())
+#define FDB_RESERVATION_NOT_FOUND 24 // the Passenger did not reserve the Flight
+#define FDB_RESERVATION_ONGOING 25   // the reserved Flight is ongoing (so it cannot be removed)
+#define FDB_MISSING_FLIGHT 26        // a saved Passenger reserved a Flight that is not in the saved flights
+#define FDB_SAVE_FAILED 27           // a save could not be written or published (the previous save is kept)
+#define FDB_EXPORT_FAILED 28         // a save was published, but flights.txt and passengers.txt could not be pointed at it
+#define FDB_JOURNAL_INVALID 29       // the journal file is not a journal (it was not replayed)
+#define FDB_JOURNAL_FAILED 30        // the journal could not be opened, cut, or replaced
+#define FDB_NO_ITINERARY 31          // no bookable Flights connect the origin to the destination (see fdb_find_itinerary())
+#define FDB_STATUS_COUNT 32          // the number of status codes
+
+/* Structures */
+
+typedef struct Date // A structure for a Date with the day, month, and year components.
+{
+    int day;                    // An int for the Day component of a Date.
+    int month;                  // An int for the Month component of a Date (1 is January).
+    int year;                   // An int for the Year component of a Date.
+} Date;
+
+typedef struct Time // A structure for a Time with the hours and minutes components.
+{
+    int hours;   // An int for the Hours component of a Time.
+    int minutes; // An int for the Minutes component of a Time.
+} Time;
+
+typedef struct DateTime // A structure for a DateTime with a Date and Time.
+{
+    struct Date date; // A Date struct for the Date component
+    struct Time time; // A Time struct for the Time component
+} DateTime;
+
+typedef struct Flight // A structure for a Flight with Flight details.
+{
+    char *flight_id;              // A str for the Flight's flight_id
+    char *destination;            // A str for the Flight's destination country (interned, shared with other Flights)
+    char *origin;                 // A str for the Flight's origin country (interned, shared with other Flights)
+    struct DateTime departure;    // A DateTime for the Flight's departure
+    struct DateTime arrival;      // A DateTime for the Flight's arrival
+    long long departure_minutes;  // A long long for the Flight's departure in minutes (cached from departure)
+    long long arrival_minutes;    // A long long for the Flight's arrival in minutes (cached from arrival)
+    _Atomic int passenger_qty;    // An atomic int for the Flight's current number of passengers (seats are claimed with a compare-and-swap)
+    int passenger_max;            // An int for the Flight's maximum number of passengers allowed
+    int bonus_miles;              // An int for the number of bonus miles a passenger gets for booking the flight
+    struct Reservation *manifest; // A ptr to the first Reservation of the Flight's manifest (every Reservation of the Flight)
+    bool is_available;            // A boolean indicating if the Flight is in the availability index
+    pthread_mutex_t lock;         // A mutex for the Flight's manifest (taken after a Passenger's lock, see fdb_book())
+    int index;                    // An int for the Flight's position in the linked list (set while saving a snapshot)
+    int skip_level;               // An int for the number of skip list levels the Flight node is part of
+    struct Flight **skip_next;    // An array of ptrs to the next Flight node at each skip list level (skip_next[0] is next)
+    struct Flight *prev;          // A ptr to the previous Flight node
+    struct Flight *next;          // A ptr to the next Flight node
+} Flight;
+
+typedef struct Reservation // A structure for a Reservation with a Flight.
+{
+    struct Flight *flight;             // A ptr to the Flight reserved
+    struct Passenger *passenger;       // A ptr to the Passenger who reserved the Flight
+    struct Reservation *prev;          // A ptr to the previous Reservation node
+    struct Reservation *next;          // A ptr to the next Reservation node
+    struct Reservation *manifest_prev; // A ptr to the previous Reservation of the same Flight
+    struct Reservation *manifest_next; // A ptr to the next Reservation of the same Flight
+} Reservation;
+
+typedef struct ScheduleEntry // A structure for the [departure, arrival] interval of a reserved Flight.
+{
+    long long departure;   // A long long for the Flight's departure in minutes
+    long long arrival;     // A long long for the Flight's arrival in minutes
+    long long max_arrival; // A long long for the latest arrival among this entry and all entries before it
+    int max_arrival_index; // An int for the index of the entry with that latest arrival
+    struct Flight *flight; // A ptr to the Flight reserved
+} ScheduleEntry;
+
+typedef struct Schedule // A structure for a Passenger's reserved intervals, sorted by departure.
+{
+    struct ScheduleEntry *entries; // An array of ScheduleEntries sorted by departure
+    int size;                      // An int for the number of entries
+    int capacity;                  // An int for the number of entries allocated
+    int version;                   // An int for the schedule version of the database the entries were computed at
+} Schedule;
+
+typedef struct Passenger // A structure for a Passenger with passenger details.
+{
+    char *first_name;                 // A str for the Passenger's first name
+    char *last_name;                  // A str for the Passenger's last name
+    struct Date birth_date;           // A Date for the Passenger's birth date
+    char *passport_number;            // A str for the Passenger's passport number
+    int miles;                        // An int for the Passenger's number of miles accumulated
+    int reservation_qty;              // An int for the Passenger's number of reservations
+    struct Reservation *reservations; // A ptr to the Passenger's (linked) list of reservations
+    struct Schedule schedule;         // A Schedule of the Passenger's reservations (for conflict checks)
+    pthread_mutex_t lock;             // A mutex for the Passenger's miles, reservations, and schedule (taken before a Flight's lock)
+    struct Passenger *prev;           // A ptr to the previous Passenger node
+    struct Passenger *next;           // A ptr to the next Passenger node
+} Passenger;
+
+typedef struct ColumnWidths // A structure counting Flights by the length of each listed column (so the widest one is known without a pass).
+{
+    int origin[COLUMN_WIDTH_LIMIT];          // An array of the number of Flights with each origin length
+    int destination[COLUMN_WIDTH_LIMIT];     // An array of the number of Flights with each destination length
+    int departure_month[COLUMN_WIDTH_LIMIT]; // An array of the number of Flights with each departure month name length
+    int arrival_month[COLUMN_WIDTH_LIMIT];   // An array of the number of Flights with each arrival month name length
+} ColumnWidths;
+
+typedef struct StringView // A string inside another buffer (NUL-terminated, but only valid until the buffer changes).
+{
+    const char *data; // A ptr to the first character
+    size_t length;    // A size for the number of characters
+} StringView;
+
+typedef struct RouteView // The Flights of one route departing at or after a time, ordered by departure (only valid until the next change).
+{
+    struct Flight **flights; // An array of ptrs to the Flights (owned by the database)
+    int count;               // An int for the number of Flights
+} RouteView;
+
+typedef struct Itinerary // A structure for the Flights of a trip from an origin to a destination, in order.
+{
+    struct Flight *legs[MAX_ITINERARY_LEGS]; // An array of ptrs to the Flights (each departs MIN_CONNECTION_MINUTES after the last one arrives, or later)
+    int leg_count;                           // An int for the number of Flights
+} Itinerary;
+
+typedef struct LineReader // A reader that reads a file in large blocks and returns one line at a time.
+{
+    FILE *fp;        // A ptr to the file being read
+    char *buffer;    // A str buffer holding the block being scanned
+    size_t capacity; // A size for the number of bytes allocated for the buffer
+    size_t start;    // A size for the index of the first unread byte
+    size_t end;      // A size for the index after the last byte read from the file
+    bool eof;        // A boolean indicating if the end of the file was reached
+} LineReader;
+
+typedef struct FlightStatus
+{
+    bool flight_departed; // A boolean indicating if a flight has departed.
+    bool flight_arrived;  // A boolean indicating if a flight has arrived.
+} FlightStatus;
+
+typedef struct LoadReport // A structure for what happened while loading a database (fdb_load() prints nothing).
+{
+    int replayed;       // An int for the number of journal changes replayed
+    int skipped;        // An int for the number of journal changes that did not fit the saved data and were skipped
+    int journal_status; // An int for the status of the journal (FDB_OK, FDB_JOURNAL_INVALID, or FDB_JOURNAL_FAILED)
+} LoadReport;
+
+typedef struct FlightDB FlightDB; // A handle to one database (its indexes, arena, journal, and clock are private to flightdb.c)
+
+/* Month Tables */
+
+extern const char *MONTHS[12];            // an array of month strings
+extern const int DAYS_IN_MONTH[2][13];    // the number of days of each month (common years, then leap years)
+
+/* Database Functions */
+
+FlightDB *fdb_create(const char *directory);   // Creates an empty database kept in a directory (NULL for the current one)
+int fdb_load(FlightDB *db, LoadReport *report); // Loads the last save and replays the journal, then keeps journaling changes
+int fdb_save(FlightDB *db);                     // Saves everything as a new save generation
+int fdb_maintain(FlightDB *db);                 // Folds the journal into a new save once it grows too large (call between changes)
+void fdb_close(FlightDB *db);                   // Closes the journal and frees everything of a database
+void fdb_set_memory_handler(void (*handler)()); // Sets the function called when memory runs out (it should not return)
+void fdb_out_of_memory();                       // Calls the memory handler and exits
+const char *fdb_status_message(int status);     // Gets the message of a status code
+
+/* Database Clock Functions (every Flight Status is checked against the clock, read once per command) */
+
+void fdb_update_time(FlightDB *db);                // Reads the clock (and drops Flights that departed from the bookable ones)
+void fdb_set_time(FlightDB *db, DateTime now);     // Sets the clock to a DateTime (it should only move forward)
+DateTime fdb_now(FlightDB *db);                    // Gets the DateTime the clock was last read at
+long long fdb_now_minutes(FlightDB *db);           // Gets the DateTime the clock was last read at in minutes
+
+/* Database Query Functions */
+
+Flight *fdb_flights(FlightDB *db);                                           // Gets the first Flight (the Flights are linked in order)
+Passenger *fdb_passengers(FlightDB *db);                                     // Gets the first Passenger (the Passengers are linked in order)
+Flight *fdb_find_flight(FlightDB *db, char *flight_id);                      // Searches for a Flight by its flight ID (NULL if there is none)
+Passenger *fdb_find_passenger(FlightDB *db, char *passport_number);          // Searches for a Passenger by their passport number (NULL if there is none)
+Flight *fdb_available_flight(FlightDB *db, int position);                    // Gets a bookable Flight by its position in order (NULL past the last one)
+RouteView fdb_search_route(FlightDB *db, char *origin, char *destination,     // Gets the Flights from an origin to a destination departing at or after a time in minutes
+                           long long departure);
+int fdb_find_itinerary(FlightDB *db, char *origin, char *destination,         // Finds the bookable Flights arriving at a destination the earliest (without conflicts
+                       long long departure, char *passport_number,           // with the reservations of a Passenger, unless passport_number is NULL) with at most
+                       Itinerary *itinerary);                                // MAX_ITINERARY_LEGS Flights (an earlier arrival needing more Flights is missed)
+const ColumnWidths *fdb_column_widths(FlightDB *db, bool available);         // Gets the column widths of every Flight or of the bookable Flights
+FlightStatus fdb_flight_status(FlightDB *db, Flight *flight);                // Gets the status of a Flight at the database's clock
+Flight *fdb_find_conflict(FlightDB *db, Passenger *passenger, Flight *flight); // Gets a reserved Flight that conflicts with a Flight (NULL if none)
+
+/* Database Change Functions (each one validates, applies, and journals a change, and returns a status code)
+    - fdb_book() and fdb_cancel() can run on many threads at once. Every other change (and fdb_update_time(), fdb_set_time(), fdb_save(), and fdb_maintain()) waits for them and runs alone.
+    - Locks are always taken in the same order: the database, then a Passenger, then a Flight, then the arena, availability index, or journal (one at a time).
+    - The query functions take no locks, so only call them while no other thread changes the database. fdb_find_conflict() and fdb_find_itinerary() with a
+      passport number still take the Passenger's lock, since checking a conflict can rebuild the Passenger's Schedule. fdb_load() and fdb_close() run before and after the threads.
+*/
+
+int fdb_add_flight(FlightDB *db, char *flight_id, char *origin, char *destination, // Adds a Flight
+                   DateTime departure, Time duration, int passenger_max, int bonus_miles);
+int fdb_edit_flight(FlightDB *db, char *flight_id,                                 // Changes the departure, duration, and seats of a Flight
+                    DateTime departure, Time duration, int passenger_max);
+int fdb_delete_flight(FlightDB *db, char *flight_id);                              // Deletes a Flight (and the reservations of an arrived one)
+int fdb_add_passenger(FlightDB *db, char *passport_number, char *first_name,       // Adds a Passenger
+                      char *last_name, Date birth_date, int miles);
+int fdb_edit_passenger(FlightDB *db, char *passport_number, char *last_name,       // Changes the last name and birth date of a Passenger
+                       Date birth_date);
+int fdb_book(FlightDB *db, char *passport_number, char *flight_id);               // Books a Flight for a Passenger
+int fdb_cancel(FlightDB *db, char *passport_number, char *flight_id);             // Removes a reservation (revoking the miles if the Flight has not departed)
+void fdb_begin_batch(FlightDB *db);                                                // Stops syncing the journal after every change
+void fdb_end_batch(FlightDB *db);                                                  // Syncs every change since fdb_begin_batch() to the disk at once
+
+/* String Helper Functions */
+
+char *toupper_string(char *string);    // Converts a string to uppercase
+char *capitalize_string(char *string); // Capitalizes a string
+
+/* Flight Status Functions */
+
+FlightStatus retrieve_flight_status(Flight *flight, long long now); // Gets the status of a flight at a time in minutes (usually the database's clock)
+void update_flight_minutes(Flight *flight);                         // Updates the cached departure and arrival minutes of a flight
+
+/* Comparison Helper Functions */
+
+int flight_compare(Flight *a, Flight *b);          // Compares two flights
+int passenger_compare(Passenger *a, Passenger *b); // Compares two passengers
+
+/* Validation Helper Functions */
+
+bool is_valid_day(int day, int month, int year);           // Checks if a day is valid
+bool is_valid_month(char *input);                          // Checks if a month is valid
+bool is_valid_nonempty_string(char *string);               // Checks if a string is valid (nonempty)
+bool is_valid_id(char *id);                                // Checks if an ID is valid
+bool is_valid_passport(char *passport_number);             // Checks if a passport is valid
+bool is_valid_birthdate(Date birth_date, DateTime now);    // Checks if a birth date is valid (at a DateTime)
+bool is_valid_duration(Time duration);                     // Checks if a duration is in range
+
+/* DateTime Helper Functions */
+
+int month_to_int(char *month);                                        // Converts a month string to its number
+const char *int_to_month(int month);                                  // Converts a month number to its string
+long long days_from_civil(int year, int month, int day);              // Converts a calendar date to days since 1 January 1970
+Date civil_from_days(long long days);                                 // Converts days since 1 January 1970 to a calendar date
+long long datetime_to_minutes(DateTime dt);                           // Converts a DateTime to minutes since 1 January 1970 00:00
+DateTime minutes_to_datetime(long long minutes);                      // Converts minutes since 1 January 1970 00:00 to a DateTime
+int days_in_month(int month, int year);                               // Gets the number of days in a month
+DateTime compute_arrival_datetime(DateTime departure, Time duration); // Gets an arrival DateTime from a departure DateTime and duration
+
+/* DateTime Check Helper Functions */
+
+bool is_conflicting(DateTime departure1, DateTime arrival1, // Checks if a DateTime is in the bounds of another DateTime
+                    DateTime departure2, DateTime arrival2);
+bool is_leap(int year);                         // Checks if a year is a leap year
+bool is_future(DateTime date1, DateTime date2); // Checks if a DateTime is in the future (from another DateTime)
+
+/* Line Reader Functions */
+
+char *read_line(FILE *stream);                               // Reads a line from a file (with automatic dynamic memory allocation)
+void line_reader_init(LineReader *reader, FILE *fp);         // Initializes a LineReader for a file
+bool line_reader_next(LineReader *reader, StringView *line); // Gets the next line of a file (false at the end of the file)
+StringView line_reader_field(LineReader *reader);            // Gets the next line of a file (an empty line at the end of the file)
+char *string_view_copy(StringView view);                     // Copies a StringView to its own allocation
+void free_line_reader(LineReader *reader);                   // Frees all memory allocated for a LineReader
+bool parse_long_long(char *string, long long *value);        // Parses a whole string as a long long
+int split_fields(char *line, char **fields, int max_fields); // Splits a line into fields in place (-1 if it has more than max_fields or an unclosed quote)
+
+/* Reservation Helper Functions */
+
+Reservation *search_reservation_node(Reservation *head, Flight *flight); // Searches for a Reservation in the linked list and returns a pointer to it
+int count_flights(Flight *head);                                         // Counts the number of Flights in the linked list
+int count_passengers(Passenger *head);                                   // Counts the number of Passengers in the linked list
+int count_reservations(Reservation *head);                               // Counts the number of Reservations in the linked list
+
+/* Column Width Functions */
+
+int column_width(const int *counts); // Gets the longest length with a nonzero count (0 if there is none)
+
+#endif
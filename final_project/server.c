@@ -0,0 +1,969 @@
+/*  Tabamo, Euan Jed S. - ST2L - June 2, 2024
+    Final Project - Flight Passenger Management System
+    Server - serves the database on a socket, and load tests a server (built against flightdb.h)
+*/
+
+#define _POSIX_C_SOURCE 200809L // for S_ISSOCK() and the socket headers under -std=c11
+
+#include "flightdb.h"
+#include "workload.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ANSI Color Codes - https://gist.github.com/RabaDabaDoba/145049536f815903c79944599c6f952a (RED and RESET are in workload.h) */
+
+#define GREEN "\e[0;92m"
+#define YELLOW "\e[0;93m"
+#define BLUE "\e[0;94m"
+
+/* Server Constants/Definitions */
+
+#define SERVER_DEFAULT_ADDRESS "flightdb.sock" // the Unix socket --serve and --load-test use if none is given (an address of only digits is a localhost TCP port)
+#define SERVER_MAX_FIELDS 9                    // the maximum number of fields of a request split (including the command name)
+#define SERVER_BACKLOG 4096                    // the number of connections that can wait to be accepted
+#define SERVER_MAX_EVENTS 256                  // the number of epoll events handled per wake-up
+#define SERVER_READ_SIZE (64 * 1024)           // the number of bytes read from a socket at once
+#define SERVER_MAX_REQUEST 1024                // the maximum length of a request line (a longer one closes the connection)
+#define SERVER_REPLY_SIZE 4096                 // the number of bytes a connection's reply buffer starts with
+#define SERVER_MAX_UNSENT (1024 * 1024)        // the number of unsent reply bytes after which a connection's requests are not read
+#define SERVER_SEARCH 0                        // the server command for searching bookable flights between two airports
+#define SERVER_VIEW 1                          // the server command for viewing a flight
+#define SERVER_BOOK 2                          // the server command for fdb_book()
+#define SERVER_CANCEL 3                        // the server command for fdb_cancel()
+#define SERVER_RESERVATIONS 4                  // the server command for viewing the reserved flights of a passenger
+#define SERVER_QUIT 5                          // the server command for closing the connection
+#define SERVER_COMMAND_COUNT 6                 // the number of server commands
+
+#define LOAD_TEST_DEFAULT_CONNECTIONS 1000 // the default number of connections --load-test opens
+#define LOAD_TEST_DEFAULT_REQUESTS 100     // the default number of requests --load-test sends on each connection
+#define LOAD_TEST_MAX_CONNECTIONS 100000   // the maximum number of connections of --load-test (the file limit is usually lower)
+#define LOAD_TEST_MAX_REQUESTS 1000000     // the maximum number of requests per connection of --load-test
+
+const char *SERVER_COMMANDS[SERVER_COMMAND_COUNT] = {"search", "view", "book", "cancel", "reservations", "quit"}; // the name of each server command
+
+const int SERVER_COMMAND_FIELDS[SERVER_COMMAND_COUNT] = {2, 1, 2, 2, 1, 0}; // the number of fields of each server command (after its name)
+
+/* Structures */
+
+typedef struct Connection // A client connection of the server and the replies it has not received yet.
+{
+    int fd;                           // An int for the connection's socket
+    char request[SERVER_MAX_REQUEST]; // A str for the part of the next request line read so far
+    size_t request_size;              // A size_t for the number of bytes of the next request read so far
+    char *reply;                      // A str for the replies to send (not NUL-terminated)
+    size_t reply_size;                // A size_t for the number of bytes of replies formatted
+    size_t reply_sent;                // A size_t for the number of those bytes already sent
+    size_t reply_capacity;            // A size_t for the number of bytes allocated for replies
+    uint32_t events;                  // A uint32_t for the epoll events the connection waits for
+    bool closing;                     // A boolean indicating if the connection closes once its replies are sent (after quit or the client's end of file)
+    bool closed;                      // A boolean indicating if the socket failed (the connection is closed after the wake-up)
+    bool pending;                     // A boolean indicating if the connection is on the Server's list of connections to flush
+    struct Connection *next_pending;  // A ptr to the next connection to flush after the wake-up
+    struct Connection *prev;          // A ptr to the previous Connection node
+    struct Connection *next;          // A ptr to the next Connection node
+} Connection;
+
+typedef struct Server // The event loop of --serve and its connections.
+{
+    FlightDB *db;            // A ptr to the database the requests run on
+    int listen_fd;           // An int for the listening socket
+    int epoll_fd;            // An int for the epoll instance every socket is registered with
+    Connection *connections; // A ptr to the first Connection (every open one)
+    Connection *pending;     // A ptr to the first Connection with replies to send after the wake-up
+    long accepted;           // A long for the number of connections accepted
+    long requests;           // A long for the number of requests handled
+} Server;
+
+typedef struct LoadClient // A connection of the load test and the request it waits for.
+{
+    int fd;                          // An int for the connection's socket
+    char line[SERVER_MAX_REQUEST];   // A str for the start of the reply line being read (longer lines are cut)
+    size_t line_size;                // A size_t for the number of bytes of the reply line read so far
+    int lines_left;                  // An int for the number of listed lines of the reply still to read (-1 until its first line is read)
+    int command;                     // An int for the server command of the request waited for
+    long passenger;                  // A long for the generated Passenger the request is for
+    long flight;                     // A long for the generated Flight the request is for
+    long booked_passenger;           // A long for the Passenger of the last booking made (-1 if it was cancelled)
+    long booked_flight;              // A long for the Flight of the last booking made
+    long requests_left;              // A long for the number of requests still to send after this one
+    unsigned long long state;        // An unsigned long long for the client's own random state
+    struct timespec sent;            // A timespec for when the request was sent
+} LoadClient;
+
+/* General Helper Functions */
+
+void out_of_memory();          // Cleanly exits the program when there is no more memory left (closing the database)
+void print_status(int status); // Prints the message of a status code a change was refused with
+
+/* Server and Load Test Functions */
+
+void run_server(FlightDB *db, char *address);                                 // Serves requests on a socket until SIGINT or SIGTERM (one thread, one epoll loop)
+void stop_server(int signal);                                                 // Asks the server to stop after the current wake-up (the SIGINT and SIGTERM handler)
+int open_socket(char *address, bool listening);                               // Opens a listening or a connected socket for an address (-1 if it failed)
+void raise_file_limit();                                                      // Raises the number of files the process can open to the most it is allowed
+void server_accept(Server *server);                                           // Accepts every waiting connection
+void server_read(Server *server, Connection *conn);                           // Reads what a connection sent and handles every complete request line
+void server_handle(Server *server, Connection *conn, char *line);             // Runs one request and formats its reply
+void server_reply(Connection *conn, const char *format, ...);                 // Formats a reply (or part of one) to a connection
+void server_reply_flight(Connection *conn, Flight *flight);                   // Formats a Flight as one line of a reply
+void server_reply_count(Connection *conn, size_t start, int count);           // Puts the OK line of a list in front of the lines formatted since start
+void server_pend(Server *server, Connection *conn);                           // Adds a connection to the list of connections to flush after the wake-up
+void server_flush(Server *server);                                            // Sends the replies of the wake-up and closes the connections that are done
+void server_close(Server *server, Connection *conn);                          // Closes a connection and frees it
+void run_load_test(char *address, int connections, long requests, Workload *workload); // Times requests sent over many connections to a server of a generated database
+void load_test_send(LoadClient *client, Workload *workload);                  // Sends the next random request of a load test connection
+
+/* Global Database */
+
+FlightDB *database = NULL; // Global Database the server serves (closed by out_of_memory())
+
+volatile sig_atomic_t server_stopping = 0; // Set by SIGINT and SIGTERM to stop the event loop of run_server()
+
+int main(int argc, char *argv[])
+{
+    // Variables
+    int status;
+    LoadReport report;
+
+    // Load test a server of a generated database
+    if (argc >= 2 && strcmp(argv[1], "--load-test") == 0)
+    {
+        Workload workload;
+        int connections = (argc >= 4) ? atoi(argv[3]) : LOAD_TEST_DEFAULT_CONNECTIONS;
+        long requests = (argc >= 5) ? atol(argv[4]) : LOAD_TEST_DEFAULT_REQUESTS;
+        if (connections < 1 || connections > LOAD_TEST_MAX_CONNECTIONS || requests < 1 || requests > LOAD_TEST_MAX_REQUESTS)
+        {
+            printf(RED "Oops! The number of connections must be from 1 to %d, and of requests per connection from 1 to %d.\n" RESET,
+                   LOAD_TEST_MAX_CONNECTIONS, LOAD_TEST_MAX_REQUESTS);
+            return EXIT_FAILURE;
+        }
+        if (!parse_workload(argc, argv, 5, &workload))
+        {
+            return EXIT_FAILURE;
+        }
+        if (workload.passengers == 0)
+        {
+            printf(RED "Oops! The number of passengers must be at least 1.\n" RESET);
+            return EXIT_FAILURE;
+        }
+        run_load_test((argc >= 3) ? argv[2] : SERVER_DEFAULT_ADDRESS, connections, requests, &workload);
+        return 0;
+    }
+
+    // Print how to run it
+    if (argc < 2 || strcmp(argv[1], "--serve") != 0)
+    {
+        printf(RED "Oops! Please enter one of:\n" RESET);
+        printf("  server --serve [address]\n");
+        printf("  server --load-test [address] [connections] [requests] [flights] [passengers] [reservations] [airports]\n");
+        return EXIT_FAILURE;
+    }
+
+    // Open the database in the current directory (it reads the clock before loading)
+    fdb_set_memory_handler(out_of_memory);
+    database = fdb_create(NULL);
+
+    // Load Flights and Passengers from files and replay the journal
+    if ((status = fdb_load(database, &report)) != FDB_OK)
+    {
+        printf(RED "Oops! %s\nCannot continue.\n" RESET, fdb_status_message(status));
+        fdb_close(database);
+        return EXIT_FAILURE;
+    }
+    if (report.journal_status != FDB_OK)
+    {
+        printf(RED "Oops! %s\n" RESET, fdb_status_message(report.journal_status));
+    }
+    if (report.replayed > 0)
+    {
+        printf(BLUE "Info: Replayed %d change(s) from %s.\n" RESET, report.replayed, JOURNAL_FILE);
+    }
+    if (report.skipped > 0)
+    {
+        printf(RED "Oops! %d change(s) in %s did not fit the saved data and were skipped.\n" RESET, report.skipped, JOURNAL_FILE);
+    }
+
+    // Serve requests on a socket until SIGINT or SIGTERM
+    run_server(database, (argc >= 3) ? argv[2] : SERVER_DEFAULT_ADDRESS);
+
+    // Close the journal and free allocated memory
+    fdb_close(database);
+
+    return 0;
+}
+
+void out_of_memory()
+{
+    // Called by the database when an allocation fails
+    printf(RED "Oops! Memory allocation failed.\n\n" RESET);
+    fdb_close(database);
+    exit(EXIT_FAILURE);
+}
+
+void print_status(int status)
+{
+    // Print the message of the status code
+    printf(RED "Oops! %s\n\n" RESET, fdb_status_message(status));
+}
+
+void run_server(FlightDB *db, char *address)
+{
+    // Variables
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    struct sigaction action = {.sa_handler = stop_server};
+    Server server = {.db = db, .listen_fd = -1, .epoll_fd = -1, .connections = NULL, .pending = NULL, .accepted = 0, .requests = 0};
+    int status;
+
+    // Allow as many connections as the process may have files open
+    raise_file_limit();
+
+    // A client that hangs up only fails its own writes, and Ctrl+C stops the server between wake-ups (epoll_wait() is not restarted)
+    signal(SIGPIPE, SIG_IGN);
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // Listen, and register the listening socket (its events carry no Connection)
+    if ((server.listen_fd = open_socket(address, true)) < 0)
+    {
+        return;
+    }
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    if ((server.epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0 || epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &event) != 0)
+    {
+        printf(RED "Oops! Could not start the event loop: %s\n" RESET, strerror(errno));
+        server_stopping = 1;
+    }
+    else
+    {
+        printf(GREEN "Serving on %s. Press Ctrl+C to stop.\n" RESET, address);
+        fflush(stdout);
+    }
+
+    while (!server_stopping)
+    {
+        // Wait until a socket is ready (or a signal arrives)
+        int count = epoll_wait(server.epoll_fd, events, SERVER_MAX_EVENTS, -1);
+        if (count < 0)
+        {
+            if (errno != EINTR)
+            {
+                printf(RED "Oops! Waiting for connections failed: %s\n" RESET, strerror(errno));
+                break;
+            }
+            continue;
+        }
+
+        // Every request of a wake-up is checked against one clock snapshot, and their journal records are synced at once
+        fdb_update_time(db);
+        fdb_begin_batch(db);
+        for (int i = 0; i < count; i++)
+        {
+            Connection *conn = (Connection *)events[i].data.ptr;
+            if (conn == NULL)
+            {
+                server_accept(&server);
+                continue;
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !conn->closing && !conn->closed)
+            {
+                server_read(&server, conn);
+            }
+            server_pend(&server, conn);
+        }
+        fdb_end_batch(db);
+
+        // Only reply once the changes are synced to the journal (an OK means the change is kept, even through a power loss)
+        server_flush(&server);
+
+        // Fold the journal into a new save once it grows too large
+        if ((status = fdb_maintain(db)) != FDB_OK)
+        {
+            print_status(status);
+        }
+    }
+
+    // Close every connection and the listening socket (and remove a Unix socket's file)
+    while (server.connections != NULL)
+    {
+        server_close(&server, server.connections);
+    }
+    if (server.epoll_fd >= 0)
+    {
+        close(server.epoll_fd);
+    }
+    close(server.listen_fd);
+    if (strspn(address, "0123456789") != strlen(address))
+    {
+        unlink(address);
+    }
+
+    printf(YELLOW "\nServer stopped after %ld connection(s) and %ld request(s).\n\n" RESET, server.accepted, server.requests);
+}
+
+void stop_server(int signal)
+{
+    (void)signal;
+    server_stopping = 1;
+}
+
+int open_socket(char *address, bool listening)
+{
+    // Variables
+    struct sockaddr_un unix_address = {.sun_family = AF_UNIX};
+    struct sockaddr_in tcp_address = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    struct sockaddr *socket_address = (struct sockaddr *)&unix_address;
+    socklen_t length = sizeof(unix_address);
+    struct stat file;
+    int fd, option = 1;
+
+    // An address of only digits is a TCP port on localhost, anything else is the path of a Unix socket
+    bool is_port = address[0] != '\0' && strspn(address, "0123456789") == strlen(address);
+    if (is_port)
+    {
+        long port = strtol(address, NULL, 10);
+        if (port < 1 || port > 65535)
+        {
+            printf(RED "Oops! The port must be from 1 to 65535.\n" RESET);
+            return -1;
+        }
+        tcp_address.sin_port = htons((uint16_t)port);
+        socket_address = (struct sockaddr *)&tcp_address;
+        length = sizeof(tcp_address);
+    }
+    else if (strlen(address) >= sizeof(unix_address.sun_path))
+    {
+        printf(RED "Oops! The socket path %s is too long.\n" RESET, address);
+        return -1;
+    }
+    else
+    {
+        strcpy(unix_address.sun_path, address);
+    }
+
+    if ((fd = socket(is_port ? AF_INET : AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0)
+    {
+        printf(RED "Oops! Could not open a socket: %s\n" RESET, strerror(errno));
+        return -1;
+    }
+
+    if (!listening)
+    {
+        // Requests are small, so send each one at once instead of waiting to fill a packet
+        if (connect(fd, socket_address, length) != 0)
+        {
+            printf(RED "Oops! Could not connect to %s: %s\n" RESET, address, strerror(errno));
+            close(fd);
+            return -1;
+        }
+        if (is_port)
+        {
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(option));
+        }
+        return fd;
+    }
+
+    // A port can be listened on again right after a restart, and a Unix socket left by a server that stopped is replaced
+    if (is_port)
+    {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+    }
+    else if (stat(address, &file) == 0 && S_ISSOCK(file.st_mode))
+    {
+        if (connect(fd, socket_address, length) == 0)
+        {
+            printf(RED "Oops! A server is already listening on %s.\n" RESET, address);
+            close(fd);
+            return -1;
+        }
+        unlink(address);
+    }
+    if (bind(fd, socket_address, length) != 0 || listen(fd, SERVER_BACKLOG) != 0 || fcntl(fd, F_SETFL, O_NONBLOCK) != 0)
+    {
+        printf(RED "Oops! Could not listen on %s: %s\n" RESET, address, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void raise_file_limit()
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+void server_accept(Server *server)
+{
+    // Variables
+    int fd, option = 1;
+
+    // Accept until no connection is waiting
+    while ((fd = accept(server->listen_fd, NULL, NULL)) >= 0)
+    {
+        // Replies are sent once per wake-up, so they do not need to wait to fill a packet (this fails harmlessly on a Unix socket)
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &option, sizeof(option));
+
+        Connection *conn = (Connection *)malloc(sizeof(Connection));
+        if (conn == NULL) // If malloc failed
+        {
+            close(fd);
+            out_of_memory();
+        }
+        *conn = (Connection){.fd = fd, .request_size = 0, .reply = NULL, .reply_size = 0, .reply_sent = 0, .reply_capacity = 0,
+                             .events = EPOLLIN, .closing = false, .closed = false, .pending = false, .next_pending = NULL,
+                             .prev = NULL, .next = server->connections};
+
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = conn};
+        if (fcntl(fd, F_SETFL, O_NONBLOCK) != 0 || epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            close(fd);
+            free(conn);
+            continue;
+        }
+
+        // Insert it at the head of the list of connections
+        if (server->connections != NULL)
+        {
+            server->connections->prev = conn;
+        }
+        server->connections = conn;
+        server->accepted++;
+    }
+
+    // Running out of files only refuses the connections waiting (they are accepted once a connection closes)
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED)
+    {
+        printf(RED "Oops! Could not accept a connection: %s\n" RESET, strerror(errno));
+    }
+}
+
+void server_read(Server *server, Connection *conn)
+{
+    // Variables
+    char buffer[SERVER_READ_SIZE];
+
+    // Read until nothing is left (or until the client reads its replies again)
+    while (!conn->closing && conn->reply_size - conn->reply_sent < SERVER_MAX_UNSENT)
+    {
+        ssize_t size = read(conn->fd, buffer, SERVER_READ_SIZE);
+        if (size < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (size < 0)
+        {
+            conn->closed = errno != EAGAIN && errno != EWOULDBLOCK;
+            return;
+        }
+
+        // The client is done sending, so close once its replies are sent
+        if (size == 0)
+        {
+            conn->closing = true;
+            return;
+        }
+
+        // Handle every complete line (the rest waits for the next read)
+        for (ssize_t i = 0; i < size && !conn->closing; i++)
+        {
+            if (buffer[i] == '\n')
+            {
+                conn->request[conn->request_size] = '\0';
+                server_handle(server, conn, conn->request);
+                conn->request_size = 0;
+            }
+            else if (conn->request_size == SERVER_MAX_REQUEST - 1)
+            {
+                server_reply(conn, "ERR Request too long.\n");
+                conn->closing = true;
+            }
+            else
+            {
+                conn->request[conn->request_size++] = buffer[i];
+            }
+        }
+    }
+}
+
+void server_handle(Server *server, Connection *conn, char *line)
+{
+    // Variables
+    char *fields[SERVER_MAX_FIELDS];
+    Flight *flight;
+    Passenger *passenger;
+    RouteView route;
+    int command = -1, count, status;
+    size_t start;
+
+    server->requests++;
+
+    // Split the request like a batch command (quotes let airports contain spaces)
+    count = split_fields(line, fields, SERVER_MAX_FIELDS);
+    if (count <= 0)
+    {
+        server_reply(conn, "ERR %s\n", (count == 0) ? "Empty request." : "Too many fields or an unclosed quote.");
+        return;
+    }
+
+    // Find the command and check its number of fields
+    for (int i = 0; i < SERVER_COMMAND_COUNT; i++)
+    {
+        if (strcmp(fields[0], SERVER_COMMANDS[i]) == 0)
+        {
+            command = i;
+        }
+    }
+    if (command == -1)
+    {
+        server_reply(conn, "ERR Unknown command '%s'.\n", fields[0]);
+        return;
+    }
+    if (count - 1 != SERVER_COMMAND_FIELDS[command])
+    {
+        server_reply(conn, "ERR %s takes %d field(s), not %d.\n", SERVER_COMMANDS[command], SERVER_COMMAND_FIELDS[command], count - 1);
+        return;
+    }
+
+    switch (command)
+    {
+    // Bookable Flights from an origin to a destination, in order of departure (the route index starts at the first one not departed)
+    case SERVER_SEARCH:
+        route = fdb_search_route(server->db, fields[1], fields[2], fdb_now_minutes(server->db) + 1);
+        start = conn->reply_size;
+        count = 0;
+        for (int i = 0; i < route.count; i++)
+        {
+            if (route.flights[i]->passenger_qty < route.flights[i]->passenger_max)
+            {
+                server_reply_flight(conn, route.flights[i]);
+                count++;
+            }
+        }
+        server_reply_count(conn, start, count);
+        break;
+
+    // One Flight
+    case SERVER_VIEW:
+        if ((flight = fdb_find_flight(server->db, fields[1])) == NULL)
+        {
+            server_reply(conn, "ERR %s\n", fdb_status_message(FDB_FLIGHT_NOT_FOUND));
+            break;
+        }
+        server_reply(conn, "OK 1\n");
+        server_reply_flight(conn, flight);
+        break;
+
+    // Book or cancel a Flight for a Passenger
+    case SERVER_BOOK:
+    case SERVER_CANCEL:
+        status = (command == SERVER_BOOK) ? fdb_book(server->db, fields[1], fields[2]) : fdb_cancel(server->db, fields[1], fields[2]);
+        if (status != FDB_OK)
+        {
+            server_reply(conn, "ERR %s\n", fdb_status_message(status));
+            break;
+        }
+        server_reply(conn, "OK 0\n");
+        break;
+
+    // The reserved Flights of a Passenger
+    case SERVER_RESERVATIONS:
+        if ((passenger = fdb_find_passenger(server->db, fields[1])) == NULL)
+        {
+            server_reply(conn, "ERR %s\n", fdb_status_message(FDB_PASSENGER_NOT_FOUND));
+            break;
+        }
+        start = conn->reply_size;
+        for (Reservation *r_ptr = passenger->reservations; r_ptr != NULL; r_ptr = r_ptr->next)
+        {
+            server_reply_flight(conn, r_ptr->flight);
+        }
+        server_reply_count(conn, start, passenger->reservation_qty);
+        break;
+
+    // Close the connection once the reply is sent
+    case SERVER_QUIT:
+        server_reply(conn, "OK 0\n");
+        conn->closing = true;
+        break;
+    }
+}
+
+void server_reply(Connection *conn, const char *format, ...)
+{
+    va_list args;
+
+    // Format into the free space first, and only grow the buffer if it did not fit
+    va_start(args, format);
+    va_list retry;
+    va_copy(retry, args);
+    int length = vsnprintf(conn->reply + conn->reply_size, conn->reply_capacity - conn->reply_size, format, args);
+    va_end(args);
+
+    if (length >= 0 && conn->reply_size + length + 1 > conn->reply_capacity)
+    {
+        size_t capacity = (conn->reply_capacity > 0) ? conn->reply_capacity : SERVER_REPLY_SIZE;
+        while (capacity < conn->reply_size + length + 1)
+        {
+            capacity *= 2;
+        }
+        char *temp = (char *)realloc(conn->reply, capacity);
+        if (temp == NULL) // If realloc failed
+        {
+            va_end(retry);
+            out_of_memory();
+        }
+        conn->reply = temp;
+        conn->reply_capacity = capacity;
+        vsnprintf(conn->reply + conn->reply_size, conn->reply_capacity - conn->reply_size, format, retry);
+    }
+    va_end(retry);
+
+    if (length > 0)
+    {
+        conn->reply_size += length;
+    }
+}
+
+void server_reply_flight(Connection *conn, Flight *flight)
+{
+    // The airports are quoted (they can contain spaces), so a reply line splits like a request
+    server_reply(conn, "%s \"%s\" \"%s\" %04d-%02d-%02d %02d:%02d %04d-%02d-%02d %02d:%02d %d %d %d\n",
+                 flight->flight_id, flight->origin, flight->destination,
+                 flight->departure.date.year, flight->departure.date.month, flight->departure.date.day,
+                 flight->departure.time.hours, flight->departure.time.minutes,
+                 flight->arrival.date.year, flight->arrival.date.month, flight->arrival.date.day,
+                 flight->arrival.time.hours, flight->arrival.time.minutes,
+                 (int)flight->passenger_qty, flight->passenger_max, flight->bonus_miles);
+}
+
+void server_reply_count(Connection *conn, size_t start, int count)
+{
+    // Variables
+    char header[32];
+    size_t listed = conn->reply_size - start;
+
+    // Format the OK line after the list (so the buffer has room), then move the list behind it
+    int length = snprintf(header, sizeof(header), "OK %d\n", count);
+    server_reply(conn, "%s", header);
+    memmove(conn->reply + start + length, conn->reply + start, listed);
+    memcpy(conn->reply + start, header, length);
+}
+
+void server_pend(Server *server, Connection *conn)
+{
+    if (!conn->pending)
+    {
+        conn->pending = true;
+        conn->next_pending = server->pending;
+        server->pending = conn;
+    }
+}
+
+void server_flush(Server *server)
+{
+    while (server->pending != NULL)
+    {
+        // Take the next connection off the list
+        Connection *conn = server->pending;
+        server->pending = conn->next_pending;
+        conn->pending = false;
+
+        // Send as much as the socket takes
+        while (!conn->closed && conn->reply_sent < conn->reply_size)
+        {
+            ssize_t size = send(conn->fd, conn->reply + conn->reply_sent, conn->reply_size - conn->reply_sent, MSG_NOSIGNAL);
+            if (size < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (size < 0)
+            {
+                conn->closed = errno != EAGAIN && errno != EWOULDBLOCK;
+                break;
+            }
+            conn->reply_sent += size;
+        }
+        if (conn->reply_sent == conn->reply_size)
+        {
+            conn->reply_size = 0;
+            conn->reply_sent = 0;
+        }
+
+        // Close it once it failed, or once a closing connection sent everything
+        if (conn->closed || (conn->closing && conn->reply_size == 0))
+        {
+            server_close(server, conn);
+            continue;
+        }
+
+        // Wait to send the rest, and stop reading while too much is unsent (or once it is closing)
+        uint32_t events = ((!conn->closing && conn->reply_size - conn->reply_sent < SERVER_MAX_UNSENT) ? EPOLLIN : 0) |
+                          ((conn->reply_sent < conn->reply_size) ? EPOLLOUT : 0);
+        if (events != conn->events)
+        {
+            struct epoll_event event = {.events = events, .data.ptr = conn};
+            epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event);
+            conn->events = events;
+        }
+    }
+}
+
+void server_close(Server *server, Connection *conn)
+{
+    // Unlink it from the list of connections
+    if (conn->prev != NULL)
+    {
+        conn->prev->next = conn->next;
+    }
+    else
+    {
+        server->connections = conn->next;
+    }
+    if (conn->next != NULL)
+    {
+        conn->next->prev = conn->prev;
+    }
+
+    // Closing the socket also removes it from epoll
+    close(conn->fd);
+    free(conn->reply);
+    free(conn);
+}
+
+void run_load_test(char *address, int connections, long requests, Workload *workload)
+{
+    // Variables
+    char buffer[SERVER_READ_SIZE], p999[16], slowest[16];
+    double *samples[SERVER_COMMAND_COUNT + 1];
+    long counts[SERVER_COMMAND_COUNT + 1] = {0}, errors[SERVER_COMMAND_COUNT + 1] = {0};
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    struct timespec begin, finish, now;
+    int epoll_fd = -1, open_count = 0, failed = 0;
+    long total = (long)connections * requests;
+    bool allocated = true;
+
+    raise_file_limit();
+    signal(SIGPIPE, SIG_IGN);
+
+    // Allocate memory for the clients and for every latency (per command, and of all requests in the last array)
+    LoadClient *clients = (LoadClient *)calloc(connections, sizeof(LoadClient));
+    for (int i = 0; i <= SERVER_COMMAND_COUNT; i++)
+    {
+        samples[i] = (double *)malloc(sizeof(double) * total);
+        allocated = allocated && samples[i] != NULL;
+    }
+    if (clients == NULL || !allocated || (epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+    {
+        printf(RED "Oops! Could not set up %d connections of %ld requests.\n" RESET, connections, requests);
+        for (int i = 0; i <= SERVER_COMMAND_COUNT; i++)
+        {
+            free(samples[i]);
+        }
+        free(clients);
+        return;
+    }
+
+    // Open every connection before sending anything, so they are all open at once
+    for (int i = 0; i < connections; i++)
+    {
+        clients[i] = (LoadClient){.fd = open_socket(address, false), .line_size = 0, .lines_left = -1, .booked_passenger = -1,
+                                  .booked_flight = -1, .requests_left = requests, .state = GENERATE_SEED + 7919ULL * (i + 1)};
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = &clients[i]};
+        if (clients[i].fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, clients[i].fd, &event) != 0)
+        {
+            printf(RED "Oops! Only %d of %d connections could be opened.\n" RESET, i, connections);
+            connections = i;
+            break;
+        }
+    }
+    printf("\n%d connections to %s, %ld requests each (1 in flight per connection).\n", connections, address, requests);
+
+    // Every connection sends a request, and the next one as soon as its reply is read
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (int i = 0; i < connections; i++)
+    {
+        load_test_send(&clients[i], workload);
+        open_count++;
+    }
+    while (open_count > 0)
+    {
+        int count = epoll_wait(epoll_fd, events, SERVER_MAX_EVENTS, -1);
+        for (int i = 0; i < count; i++)
+        {
+            LoadClient *client = (LoadClient *)events[i].data.ptr;
+            ssize_t size = read(client->fd, buffer, SERVER_READ_SIZE);
+            if (size <= 0)
+            {
+                // The server closed the connection (or failed) before every reply came
+                if (size < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                close(client->fd);
+                open_count--;
+                failed++;
+                continue;
+            }
+            for (ssize_t j = 0; j < size; j++)
+            {
+                // Keep the start of the line (only the first line of a reply is read)
+                if (buffer[j] != '\n')
+                {
+                    if (client->line_size < SERVER_MAX_REQUEST - 1)
+                    {
+                        client->line[client->line_size++] = buffer[j];
+                    }
+                    continue;
+                }
+                client->line[client->line_size] = '\0';
+                client->line_size = 0;
+
+                // An OK line says how many listed lines follow it
+                if (client->lines_left == -1)
+                {
+                    if (strncmp(client->line, "OK ", 3) == 0)
+                    {
+                        client->lines_left = atoi(client->line + 3);
+                    }
+                    else
+                    {
+                        client->lines_left = 0;
+                        errors[client->command]++;
+                        errors[SERVER_COMMAND_COUNT]++;
+                    }
+                }
+                else
+                {
+                    client->lines_left--;
+                }
+                if (client->lines_left > 0)
+                {
+                    continue;
+                }
+
+                // The reply is complete, so time it
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                double seconds = elapsed_seconds(client->sent, now);
+                samples[client->command][counts[client->command]++] = seconds;
+                samples[SERVER_COMMAND_COUNT][counts[SERVER_COMMAND_COUNT]++] = seconds;
+                if (client->command == SERVER_BOOK && strncmp(client->line, "OK", 2) == 0)
+                {
+                    client->booked_passenger = client->passenger;
+                    client->booked_flight = client->flight;
+                }
+                client->lines_left = -1;
+
+                // Send the next request, or close the connection after the last one
+                if (client->requests_left > 0)
+                {
+                    load_test_send(client, workload);
+                }
+                else
+                {
+                    close(client->fd);
+                    open_count--;
+                    break;
+                }
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    close(epoll_fd);
+
+    // Report every command, then every request (the throughput is of all connections together)
+    double seconds = elapsed_seconds(begin, finish);
+    printf("\n%-22s %8s %12s %12s %16s\n", "Request", "Count", "p50", "p99", "Throughput");
+    for (int i = 0; i <= SERVER_COMMAND_COUNT; i++)
+    {
+        if (counts[i] > 0)
+        {
+            benchmark_report((i < SERVER_COMMAND_COUNT) ? SERVER_COMMANDS[i] : "all requests", samples[i], counts[i], seconds);
+        }
+    }
+    if (counts[SERVER_COMMAND_COUNT] > 0)
+    {
+        format_latency(samples[SERVER_COMMAND_COUNT][(counts[SERVER_COMMAND_COUNT] - 1) * 999 / 1000], p999);
+        format_latency(samples[SERVER_COMMAND_COUNT][counts[SERVER_COMMAND_COUNT] - 1], slowest);
+        printf("\np99.9 of all requests: %s, slowest: %s\n", p999, slowest);
+    }
+    printf("ERR replies: %ld of %ld searches, %ld of %ld views, %ld of %ld bookings, %ld of %ld cancellations\n",
+           errors[SERVER_SEARCH], counts[SERVER_SEARCH], errors[SERVER_VIEW], counts[SERVER_VIEW],
+           errors[SERVER_BOOK], counts[SERVER_BOOK], errors[SERVER_CANCEL], counts[SERVER_CANCEL]);
+    if (failed > 0)
+    {
+        printf(RED "Oops! The server closed %d connection(s) before every reply came.\n" RESET, failed);
+    }
+    printf(BLUE "Info: ERR replies are refusals, like booking a full or conflicting flight, or cancelling a flight that was not booked.\n" RESET);
+
+    for (int i = 0; i <= SERVER_COMMAND_COUNT; i++)
+    {
+        free(samples[i]);
+    }
+    free(clients);
+}
+
+void load_test_send(LoadClient *client, Workload *workload)
+{
+    // Variables
+    char request[SERVER_MAX_REQUEST], flight_id[FLIGHT_ID_STR_LEN + 1], origin[4], destination[4];
+    int length, roll = (int)(next_random(&client->state) % 100);
+
+    // Pick a random Passenger and Flight (the passport numbers and flight IDs of generated ones follow from their numbers)
+    client->passenger = (long)(next_random(&client->state) % workload->passengers);
+    client->flight = (long)(next_random(&client->state) % workload->flights);
+    client->requests_left--;
+
+    // Half are views, a tenth searches, a quarter bookings, and the rest cancel the client's last booking (or a random one)
+    if (roll < 50)
+    {
+        client->command = SERVER_VIEW;
+        generated_flight_id(client->flight, flight_id);
+        length = snprintf(request, sizeof(request), "view %s\n", flight_id);
+    }
+    else if (roll < 60)
+    {
+        client->command = SERVER_SEARCH;
+        generated_airport((int)(next_random(&client->state) % workload->airports), workload->airports, origin);
+        generated_airport((int)(next_random(&client->state) % workload->airports), workload->airports, destination);
+        length = snprintf(request, sizeof(request), "search %s %s\n", origin, destination);
+    }
+    else
+    {
+        client->command = (roll < 85) ? SERVER_BOOK : SERVER_CANCEL;
+        if (client->command == SERVER_CANCEL && client->booked_passenger != -1)
+        {
+            client->passenger = client->booked_passenger;
+            client->flight = client->booked_flight;
+            client->booked_passenger = -1;
+        }
+        generated_flight_id(client->flight, flight_id);
+        length = snprintf(request, sizeof(request), "%s P%08ld %s\n", SERVER_COMMANDS[client->command], client->passenger, flight_id);
+    }
+
+    // A request is far smaller than the socket buffer, so it is written at once
+    clock_gettime(CLOCK_MONOTONIC, &client->sent);
+    if (write(client->fd, request, length) != length)
+    {
+        printf(RED "Oops! Could not send a request: %s\n" RESET, strerror(errno));
+    }
+}
@@ -0,0 +1,296 @@
+/*  Tabamo, Euan Jed S. - ST2L - June 2, 2024
+    Final Project - Flight Passenger Management System
+    Workload Generator - generated databases and latency reports shared by the benchmarks and the load test (see workload.h)
+*/
+
+#define _POSIX_C_SOURCE 200809L // for mkdir() and clock_gettime() under -std=c11
+
+#include "workload.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Workload Constants */
+
+const char *GENERATE_FIRST_NAMES[GENERATE_NAME_COUNT] = {"Andrea", "Bea", "Carlo", "Dana", "Elijah", "Francis", "Gabriel", // first names of generated passengers (sorted)
+                                                         "Hannah", "Isabel", "Jose", "Kim", "Liza", "Marco", "Nina",
+                                                         "Paolo", "Rafael", "Sofia", "Tomas", "Victor", "Ysa"};
+
+const char *GENERATE_LAST_NAMES[GENERATE_NAME_COUNT] = {"Aquino", "Bautista", "Castillo", "Dela Cruz", "Espiritu", "Flores", "Garcia", // last names of generated passengers (sorted)
+                                                        "Hernandez", "Ignacio", "Jimenez", "Lim", "Mendoza", "Navarro", "Ocampo",
+                                                        "Pascual", "Quiambao", "Reyes", "Santos", "Tan", "Villanueva"};
+
+/* Structures */
+
+typedef struct GeneratedFlight // A Flight of a generated database, before it is written.
+{
+    long long departure; // A long long for the departure in minutes
+    int duration;        // An int for the duration in minutes
+    int origin;          // An int for the origin's airport number
+    int destination;     // An int for the destination's airport number
+    int passenger_max;   // An int for the maximum number of passengers
+    int passenger_qty;   // An int for the number of reservations generated so far
+    int bonus_miles;     // An int for the bonus miles
+} GeneratedFlight;
+
+bool parse_workload(int argc, char *argv[], int first, Workload *workload)
+{
+    // Variables
+    long values[4] = {GENERATE_DEFAULT_FLIGHTS, GENERATE_DEFAULT_PASSENGERS, GENERATE_DEFAULT_RESERVATIONS, GENERATE_DEFAULT_AIRPORTS};
+    const long limits[4] = {GENERATE_MAX_FLIGHTS, GENERATE_MAX_PASSENGERS, GENERATE_MAX_RESERVATIONS, GENERATE_MAX_AIRPORTS};
+    const long minimums[4] = {1, 0, 0, 2};
+    const char *names[4] = {"flights", "passengers", "reservations per passenger", "airports"};
+
+    // Every size is optional, in order (flights, passengers, reservations per passenger, airports)
+    for (int i = 0; i < 4 && first + i < argc; i++)
+    {
+        char *end;
+        values[i] = strtol(argv[first + i], &end, 10);
+        if (end == argv[first + i] || *end != '\0' || values[i] < minimums[i] || values[i] > limits[i])
+        {
+            printf(RED "Oops! The number of %s must be from %ld to %ld.\n" RESET, names[i], minimums[i], limits[i]);
+            return false;
+        }
+    }
+
+    *workload = (Workload){.flights = values[0], .passengers = values[1], .reservations = (int)values[2], .airports = (int)values[3]};
+    return true;
+}
+
+bool generate_workload(char *directory, Workload *workload)
+{
+    // Variables
+    char flights_filename[MAX_FILENAME_LENGTH], passengers_filename[MAX_FILENAME_LENGTH];
+    char flight_id[FLIGHT_ID_STR_LEN + 1], origin[4], destination[4];
+    unsigned long long state = GENERATE_SEED;
+    long reservation_count = 0;
+    struct timespec begin, finish;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+
+    // Never overwrite a database (its journal would be replayed over the generated files)
+    snprintf(flights_filename, MAX_FILENAME_LENGTH, "%s/%s", directory, FLIGHTS_FILE);
+    snprintf(passengers_filename, MAX_FILENAME_LENGTH, "%s/%s", directory, PASSENGERS_FILE);
+    if (mkdir(directory, 0755) != 0 && access(flights_filename, F_OK) == 0)
+    {
+        printf(RED "Oops! %s already has a database.\n" RESET, directory);
+        return false;
+    }
+
+    // Flights depart in order, at least a minute apart, over the year starting tomorrow
+    time_t now = time(NULL);
+    struct tm local_time;
+    localtime_r(&now, &local_time);
+    DateTime today = {.date = {.day = local_time.tm_mday, .month = local_time.tm_mon + 1, .year = local_time.tm_year + 1900}};
+    long long first_departure = datetime_to_minutes(today) + 24 * 60;
+    long long span = (workload->flights > 365 * 24 * 60) ? workload->flights : 365 * 24 * 60;
+
+    GeneratedFlight *flights = (GeneratedFlight *)malloc(sizeof(GeneratedFlight) * workload->flights);
+    int *reserved = (int *)malloc(sizeof(int) * ((workload->passengers * workload->reservations) + 1));
+    int *reserved_qty = (int *)malloc(sizeof(int) * (workload->passengers + 1));
+    if (flights == NULL || reserved == NULL || reserved_qty == NULL) // If malloc failed
+    {
+        free(flights);
+        free(reserved);
+        free(reserved_qty);
+        fdb_out_of_memory();
+    }
+
+    for (long i = 0; i < workload->flights; i++)
+    {
+        GeneratedFlight *flight = &flights[i];
+        flight->departure = first_departure + i * span / workload->flights;
+        flight->duration = 45 + (int)(next_random(&state) % (12 * 60 - 45 + 1)); // 45 minutes to 12 hours
+        flight->origin = (int)(next_random(&state) % workload->airports);
+        flight->destination = (flight->origin + 1 + (int)(next_random(&state) % (workload->airports - 1))) % workload->airports;
+        flight->passenger_max = 100 + (int)(next_random(&state) % 251); // 100 to 350 seats
+        flight->passenger_qty = 0;
+        flight->bonus_miles = flight->duration * 8;
+    }
+
+    // Each Passenger's reservations follow each other in time (so none of them conflict), on Flights with a free seat
+    for (long p = 0; p < workload->passengers; p++)
+    {
+        long long earliest = first_departure + (long long)(next_random(&state) % span);
+        reserved_qty[p] = 0;
+        for (int r = 0; r < workload->reservations; r++)
+        {
+            // Find the first Flight departing at or after the earliest departure (binary search)
+            long low = 0, high = workload->flights;
+            while (low < high)
+            {
+                long middle = low + (high - low) / 2;
+                if (flights[middle].departure < earliest)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+
+            // Take the first of the next few Flights that still has a seat
+            long chosen = -1;
+            for (long i = low; i < workload->flights && i < low + GENERATE_SEAT_PROBES; i++)
+            {
+                if (flights[i].passenger_qty < flights[i].passenger_max)
+                {
+                    chosen = i;
+                    break;
+                }
+            }
+            if (chosen == -1)
+            {
+                break;
+            }
+
+            flights[chosen].passenger_qty++;
+            reserved[p * workload->reservations + reserved_qty[p]++] = (int)chosen;
+            reservation_count++;
+
+            // The next one departs an hour to three days after this one arrives
+            earliest = flights[chosen].departure + flights[chosen].duration + 60 + (long long)(next_random(&state) % (3 * 24 * 60));
+        }
+    }
+
+    // Write the Flights in the format (and order) save() writes them
+    FILE *fp = fopen(flights_filename, "w");
+    if (fp == NULL)
+    {
+        printf(RED "Error creating %s\n" RESET, flights_filename);
+        free(flights);
+        free(reserved);
+        free(reserved_qty);
+        return false;
+    }
+    fprintf(fp, "%ld\n", workload->flights);
+    for (long i = 0; i < workload->flights; i++)
+    {
+        DateTime departure = minutes_to_datetime(flights[i].departure);
+        DateTime arrival = minutes_to_datetime(flights[i].departure + flights[i].duration);
+        generated_flight_id(i, flight_id);
+        generated_airport(flights[i].origin, workload->airports, origin);
+        generated_airport(flights[i].destination, workload->airports, destination);
+        fprintf(fp, "%s\n%s\n%s\n", flight_id, origin, destination);
+        fprintf(fp, "%d %s %d - %02d:%02d\n", departure.date.day, int_to_month(departure.date.month), departure.date.year,
+                departure.time.hours, departure.time.minutes);
+        fprintf(fp, "%d %s %d - %02d:%02d\n", arrival.date.day, int_to_month(arrival.date.month), arrival.date.year,
+                arrival.time.hours, arrival.time.minutes);
+        fprintf(fp, "%d\n%d\n%d\n", flights[i].passenger_qty, flights[i].passenger_max, flights[i].bonus_miles);
+    }
+    fclose(fp);
+
+    // Write the Passengers (their names only grow with their number, so they are already in order)
+    fp = fopen(passengers_filename, "w");
+    if (fp == NULL)
+    {
+        printf(RED "Error creating %s\n" RESET, passengers_filename);
+        free(flights);
+        free(reserved);
+        free(reserved_qty);
+        return false;
+    }
+    fprintf(fp, "%ld\n", workload->passengers);
+    for (long p = 0; p < workload->passengers; p++)
+    {
+        long name = p * (GENERATE_NAME_COUNT * GENERATE_NAME_COUNT) / workload->passengers;
+        fprintf(fp, "%s\n%s\nP%08ld\n", GENERATE_LAST_NAMES[name % GENERATE_NAME_COUNT], GENERATE_FIRST_NAMES[name / GENERATE_NAME_COUNT], p);
+        fprintf(fp, "%d %s %d\n", 1 + (int)(next_random(&state) % 28), MONTHS[next_random(&state) % 12], 1945 + (int)(next_random(&state) % 61));
+        fprintf(fp, "%d\n", reserved_qty[p]);
+        for (int r = 0; r < reserved_qty[p]; r++)
+        {
+            generated_flight_id(reserved[p * workload->reservations + r], flight_id);
+            fprintf(fp, "%s\n", flight_id);
+        }
+        fprintf(fp, "%d\n", (int)(next_random(&state) % 50001));
+    }
+    fclose(fp);
+
+    clock_gettime(CLOCK_MONOTONIC, &finish);
+    printf("Generated %ld flights, %ld passengers, and %ld reservations in %s (%.2f s).\n",
+           workload->flights, workload->passengers, reservation_count, directory, elapsed_seconds(begin, finish));
+
+    free(flights);
+    free(reserved);
+    free(reserved_qty);
+    return true;
+}
+
+unsigned long long next_random(unsigned long long *state)
+{
+    // xorshift64* (fast, and good enough to spread the generated data)
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+void generated_flight_id(long index, char *flight_id)
+{
+    // Two letters count the ten thousands, then four digits
+    long prefix = index / 10000, number = index % 10000;
+    flight_id[0] = (char)('A' + prefix / 26);
+    flight_id[1] = (char)('A' + prefix % 26);
+    for (int i = FLIGHT_ID_STR_LEN - 1; i >= 2; i--, number /= 10)
+    {
+        flight_id[i] = (char)('0' + number % 10);
+    }
+    flight_id[FLIGHT_ID_STR_LEN] = '\0';
+}
+
+void generated_airport(int index, int airports, char *code)
+{
+    // Spread the codes over every three-letter code instead of only the first ones
+    int spread = index * (GENERATE_MAX_AIRPORTS / airports);
+    code[0] = (char)('A' + spread / (26 * 26));
+    code[1] = (char)('A' + spread / 26 % 26);
+    code[2] = (char)('A' + spread % 26);
+    code[3] = '\0';
+}
+
+void benchmark_report(const char *operation, double *samples, long count, double seconds)
+{
+    // Variables
+    char p50[16], p99[16];
+
+    // Sort the latencies to read the percentiles
+    qsort(samples, count, sizeof(double), compare_seconds);
+    format_latency(samples[(count - 1) * 50 / 100], p50);
+    format_latency(samples[(count - 1) * 99 / 100], p99);
+
+    printf("%-22s %8ld %12s %12s %12.1f op/s\n", operation, count, p50, p99, count / seconds);
+}
+
+void format_latency(double seconds, char *buffer)
+{
+    if (seconds < 1e-6)
+    {
+        sprintf(buffer, "%.0f ns", seconds * 1e9);
+    }
+    else if (seconds < 1e-3)
+    {
+        sprintf(buffer, "%.2f us", seconds * 1e6);
+    }
+    else if (seconds < 1)
+    {
+        sprintf(buffer, "%.2f ms", seconds * 1e3);
+    }
+    else
+    {
+        sprintf(buffer, "%.2f s", seconds);
+    }
+}
+
+double elapsed_seconds(struct timespec begin, struct timespec finish)
+{
+    return (finish.tv_sec - begin.tv_sec) + (finish.tv_nsec - begin.tv_nsec) / 1e9;
+}
+
+int compare_seconds(const void *a, const void *b)
+{
+    double difference = *(const double *)a - *(const double *)b;
+    return (difference > 0) - (difference < 0);
+}
@@ -0,0 +1,57 @@
+/*  Tabamo, Euan Jed S. - ST2L - June 2, 2024
+    Final Project - Flight Passenger Management System
+    Workload Generator - generated databases and latency reports shared by the benchmarks and the load test
+*/
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "flightdb.h"
+
+#include <time.h>
+
+/* ANSI Color Codes - https://gist.github.com/RabaDabaDoba/145049536f815903c79944599c6f952a */
+
+#define RED "\e[0;91m"
+#define RESET "\e[0m"
+
+/* Workload Constants/Definitions */
+
+#define GENERATE_DEFAULT_FLIGHTS 100000      // the default number of flights generated by --generate and --bench
+#define GENERATE_DEFAULT_PASSENGERS 50000    // the default number of passengers generated by --generate and --bench
+#define GENERATE_DEFAULT_RESERVATIONS 3      // the default number of reservations generated per passenger
+#define GENERATE_DEFAULT_AIRPORTS 50         // the default number of airports generated flights fly between
+#define GENERATE_MAX_FLIGHTS (26 * 26 * 10000) // the maximum number of generated flights (IDs are two letters and four digits)
+#define GENERATE_MAX_PASSENGERS 100000000    // the maximum number of generated passengers (passport numbers are P and eight digits)
+#define GENERATE_MAX_RESERVATIONS 100        // the maximum number of reservations generated per passenger
+#define GENERATE_MAX_AIRPORTS (26 * 26 * 26) // the maximum number of generated airports (codes are three letters)
+#define GENERATE_SEED 20240602ULL            // the seed of the generator (the same sizes always generate the same files)
+#define GENERATE_SEAT_PROBES 64              // the number of flights tried after a departure for one with a free seat
+#define GENERATE_NAME_COUNT 20               // the number of first names and of last names generated passengers get
+
+/* Structures */
+
+typedef struct Workload // The sizes of a generated database.
+{
+    long flights;     // A long for the number of Flights
+    long passengers;  // A long for the number of Passengers
+    int reservations; // An int for the number of reservations per Passenger (fewer if no Flight with a free seat is found)
+    int airports;     // An int for the number of airports the Flights fly between
+} Workload;
+
+/* Workload Generator Functions */
+
+bool parse_workload(int argc, char *argv[], int first, Workload *workload); // Reads the sizes of a workload from the arguments from first onward (defaults for missing ones)
+bool generate_workload(char *directory, Workload *workload);               // Writes a flights.txt and passengers.txt of a workload's sizes to a directory
+unsigned long long next_random(unsigned long long *state);                 // Gets the next number of a xorshift64* generator
+void generated_flight_id(long index, char *flight_id);                     // Gets the flight ID of a generated Flight (two letters and four digits)
+void generated_airport(int index, int airports, char *code);               // Gets the three-letter code of a generated airport
+
+/* Latency Report Functions */
+
+void benchmark_report(const char *operation, double *samples, long count, double seconds); // Prints the p50 and p99 latency and the throughput of an operation
+void format_latency(double seconds, char *buffer);                                  // Formats a latency with a unit that fits it (ns, us, ms, or s)
+double elapsed_seconds(struct timespec begin, struct timespec finish);              // Gets the seconds between two clock readings
+int compare_seconds(const void *a, const void *b);                                  // Compares two latencies (for qsort())
+
+#endif